@@ -3,3 +3,85 @@
 
 #include "Hex.h"
 
+#include <cmath>
+
+Hex Hex::Add(const Hex A, const Hex B)
+{
+	return Hex(A.Q + B.Q, A.R + B.R, A.S + B.S);
+}
+
+Hex Hex::Subtract(const Hex A, const Hex B)
+{
+	return Hex(A.Q - B.Q, A.R - B.R, A.S - B.S);
+}
+
+Hex Hex::Multiply(const Hex Tile, const int Multiplier)
+{
+	return Hex(Tile.Q * Multiplier, Tile.R * Multiplier, Tile.S * Multiplier);
+}
+
+Hex Hex::Divide(const Hex Tile, const int Divisor)
+{
+	return Hex(Tile.Q / Divisor, Tile.R / Divisor, Tile.S / Divisor);
+}
+
+int Hex::Length(const Hex Tile)
+{
+	return (
+		int(FMath::Abs(Tile.Q) +
+		FMath::Abs(Tile.R) +
+		FMath::Abs(Tile.S)) / 2);
+}
+
+int Hex::ManhattanDistance(const Hex& A, const Hex& B)
+{
+    return FMath::Abs(A.Q - B.Q) + FMath::Abs(A.R - B.R) + FMath::Abs(A.S - B.S);
+}
+
+int Hex::Distance(const Hex& A, const Hex& B)
+{
+	return Length(Subtract(A, B));
+}
+
+int Hex::GetHexCountForRange(const int Range)
+{
+	return 3 * Range * (Range + 1);
+}
+
+FractionalHex Hex::Lerp(Hex a, Hex b, double t)
+{
+    return FractionalHex(PreciseLerp(a.Q, b.Q, t),
+                         PreciseLerp(a.R, b.R, t),
+                         PreciseLerp(a.S, b.S, t));
+}
+
+Hex Hex::Round(const FractionalHex h)
+{
+	int q = int(round(h.Q));
+	int r = int(round(h.R));
+	int s = int(round(h.S));
+	double q_diff = abs(q - h.Q);
+	double r_diff = abs(r - h.R);
+	double s_diff = abs(s - h.S);
+	if (q_diff > r_diff && q_diff > s_diff)
+	{
+		q = -r - s;
+	}
+	else if (r_diff > s_diff)
+	{
+		r = -q - s;
+	}
+	else
+	{
+		s = -q - r;
+	}
+	
+	return Hex(q, r, s);
+}
+
+float Hex::PreciseLerp(double a, double b, double t)
+{
+    return a * (1-t) + b * t;
+    /* better for floating point precision than
+       a + (b - a) * t, which is what I usually write */
+}
@@ -5,6 +5,14 @@
 #include "CoreMinimal.h"
 #include "HexEnum.h"
 
+// Fraction
+struct FractionalHex
+{
+	const double Q, R, S;
+	FractionalHex(double q_, double r_, double s_)
+	: Q(q_), R(r_), S(s_) {}
+};
+
 /**
  * 
  */
@@ -33,6 +41,28 @@ struct UOCTEST_API Hex
     {
         return std::tie(Q, R, S) < std::tie(Tile.Q, Tile.R, Tile.S);
     }
+
+    // Arithmetics
+    static Hex Add(const Hex A, const Hex B);
+    static Hex Subtract(const Hex A, const Hex B);
+    static Hex Multiply(const Hex Tile, int Multiplier);
+    static Hex Divide(const Hex Tile, int Divisor);
+
+    static int Length(const Hex Tile);
+    static int ManhattanDistance(const Hex& A, const Hex& B);
+    static int Distance(const Hex& A, const Hex& B);
+
+    // Returns the number of hexes in a desired Range
+    static int GetHexCountForRange(int Range);
+
+    // Lerp hex
+    static FractionalHex Lerp(Hex a, Hex b, double t);
+
+    // Rounding from fractal coordinates
+    static Hex Round(FractionalHex h);
+
+    // Better precision lerp
+    static float PreciseLerp(double a, double b, double t);
     
 	int Q;
 	int R;
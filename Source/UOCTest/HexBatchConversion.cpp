@@ -0,0 +1,236 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexBatchConversion.h"
+
+#include <cmath>
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && (PLATFORM_ALWAYS_HAS_AVX_2 || PLATFORM_ALWAYS_HAS_SSE4_1)
+#include <immintrin.h>
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON && PLATFORM_64BITS
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // Scalar path, mirrors Hex::Round
+    void RoundOne(const double Q, const double R, int32& OutQ, int32& OutR)
+    {
+        const double S = -Q - R;
+        int q = int(std::round(Q));
+        int r = int(std::round(R));
+        const int s = int(std::round(S));
+        const double QDiff = std::abs(q - Q);
+        const double RDiff = std::abs(r - R);
+        const double SDiff = std::abs(s - S);
+        if (QDiff > RDiff && QDiff > SDiff)
+        {
+            q = -r - s;
+        }
+        else if (RDiff > SDiff)
+        {
+            r = -q - s;
+        }
+
+        OutQ = q;
+        OutR = r;
+    }
+
+    // Mirrors AHexGridManager::LocationToFractionalHex, world Y drives Q
+    void ToFractional(const double X, const double Y, const double Size, double& OutQ, double& OutR)
+    {
+        const double PointX = Y / Size;
+        const double PointY = X / Size;
+        OutQ = (2.0 / 3.0) * PointX;
+        OutR = (-1.0 / 3.0) * PointX + std::sqrt(3.0) / 3.0 * PointY;
+    }
+
+    // Multiplies and adds are kept apart in the kernels, fusing them would round differently from the scalar path.
+    // std::round rounds halves away from zero: truncate, then step away from zero when half or more was cut off.
+    // Both steps are exact, unlike adding 0.5 first.
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_ALWAYS_HAS_AVX_2
+    constexpr int Lanes = 4;
+
+    __m256d RoundHalfAway(const __m256d V)
+    {
+        const __m256d SignBit = _mm256_set1_pd(-0.0);
+        const __m256d Truncated = _mm256_round_pd(V, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        const __m256d CutOff = _mm256_andnot_pd(SignBit, _mm256_sub_pd(V, Truncated));
+        const __m256d Step = _mm256_or_pd(_mm256_set1_pd(1.0), _mm256_and_pd(V, SignBit));
+        return _mm256_add_pd(Truncated, _mm256_and_pd(_mm256_cmp_pd(CutOff, _mm256_set1_pd(0.5), _CMP_GE_OQ), Step));
+    }
+
+    void RoundLanes(const __m256d Q, const __m256d R, int32* OutQ, int32* OutR)
+    {
+        const __m256d SignBit = _mm256_set1_pd(-0.0);
+        const __m256d S = _mm256_sub_pd(_mm256_xor_pd(Q, SignBit), R);
+        const __m256d RoundedQ = RoundHalfAway(Q);
+        const __m256d RoundedR = RoundHalfAway(R);
+        const __m256d RoundedS = RoundHalfAway(S);
+        const __m256d QDiff = _mm256_andnot_pd(SignBit, _mm256_sub_pd(RoundedQ, Q));
+        const __m256d RDiff = _mm256_andnot_pd(SignBit, _mm256_sub_pd(RoundedR, R));
+        const __m256d SDiff = _mm256_andnot_pd(SignBit, _mm256_sub_pd(RoundedS, S));
+
+        const __m256d FixQ = _mm256_and_pd(_mm256_cmp_pd(QDiff, RDiff, _CMP_GT_OQ), _mm256_cmp_pd(QDiff, SDiff, _CMP_GT_OQ));
+        const __m256d FixR = _mm256_andnot_pd(FixQ, _mm256_cmp_pd(RDiff, SDiff, _CMP_GT_OQ));
+        const __m256d FinalQ = _mm256_blendv_pd(RoundedQ, _mm256_sub_pd(_mm256_xor_pd(RoundedR, SignBit), RoundedS), FixQ);
+        const __m256d FinalR = _mm256_blendv_pd(RoundedR, _mm256_sub_pd(_mm256_xor_pd(RoundedQ, SignBit), RoundedS), FixR);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(OutQ), _mm256_cvttpd_epi32(FinalQ));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(OutR), _mm256_cvttpd_epi32(FinalR));
+    }
+
+    void RoundBlock(const double* Q, const double* R, int32* OutQ, int32* OutR)
+    {
+        RoundLanes(_mm256_loadu_pd(Q), _mm256_loadu_pd(R), OutQ, OutR);
+    }
+
+    void WorldBlock(const double* X, const double* Y, const double Size, int32* OutQ, int32* OutR)
+    {
+        const __m256d Divisor = _mm256_set1_pd(Size);
+        const __m256d PointX = _mm256_div_pd(_mm256_loadu_pd(Y), Divisor);
+        const __m256d PointY = _mm256_div_pd(_mm256_loadu_pd(X), Divisor);
+        const __m256d Q = _mm256_mul_pd(_mm256_set1_pd(2.0 / 3.0), PointX);
+        const __m256d R = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(-1.0 / 3.0), PointX), _mm256_mul_pd(_mm256_set1_pd(std::sqrt(3.0) / 3.0), PointY));
+        RoundLanes(Q, R, OutQ, OutR);
+    }
+
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_ALWAYS_HAS_SSE4_1
+    constexpr int Lanes = 2;
+
+    __m128d RoundHalfAway(const __m128d V)
+    {
+        const __m128d SignBit = _mm_set1_pd(-0.0);
+        const __m128d Truncated = _mm_round_pd(V, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        const __m128d CutOff = _mm_andnot_pd(SignBit, _mm_sub_pd(V, Truncated));
+        const __m128d Step = _mm_or_pd(_mm_set1_pd(1.0), _mm_and_pd(V, SignBit));
+        return _mm_add_pd(Truncated, _mm_and_pd(_mm_cmpge_pd(CutOff, _mm_set1_pd(0.5)), Step));
+    }
+
+    void RoundLanes(const __m128d Q, const __m128d R, int32* OutQ, int32* OutR)
+    {
+        const __m128d SignBit = _mm_set1_pd(-0.0);
+        const __m128d S = _mm_sub_pd(_mm_xor_pd(Q, SignBit), R);
+        const __m128d RoundedQ = RoundHalfAway(Q);
+        const __m128d RoundedR = RoundHalfAway(R);
+        const __m128d RoundedS = RoundHalfAway(S);
+        const __m128d QDiff = _mm_andnot_pd(SignBit, _mm_sub_pd(RoundedQ, Q));
+        const __m128d RDiff = _mm_andnot_pd(SignBit, _mm_sub_pd(RoundedR, R));
+        const __m128d SDiff = _mm_andnot_pd(SignBit, _mm_sub_pd(RoundedS, S));
+
+        const __m128d FixQ = _mm_and_pd(_mm_cmpgt_pd(QDiff, RDiff), _mm_cmpgt_pd(QDiff, SDiff));
+        const __m128d FixR = _mm_andnot_pd(FixQ, _mm_cmpgt_pd(RDiff, SDiff));
+        const __m128d FinalQ = _mm_blendv_pd(RoundedQ, _mm_sub_pd(_mm_xor_pd(RoundedR, SignBit), RoundedS), FixQ);
+        const __m128d FinalR = _mm_blendv_pd(RoundedR, _mm_sub_pd(_mm_xor_pd(RoundedQ, SignBit), RoundedS), FixR);
+
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(OutQ), _mm_cvttpd_epi32(FinalQ));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(OutR), _mm_cvttpd_epi32(FinalR));
+    }
+
+    void RoundBlock(const double* Q, const double* R, int32* OutQ, int32* OutR)
+    {
+        RoundLanes(_mm_loadu_pd(Q), _mm_loadu_pd(R), OutQ, OutR);
+    }
+
+    void WorldBlock(const double* X, const double* Y, const double Size, int32* OutQ, int32* OutR)
+    {
+        const __m128d Divisor = _mm_set1_pd(Size);
+        const __m128d PointX = _mm_div_pd(_mm_loadu_pd(Y), Divisor);
+        const __m128d PointY = _mm_div_pd(_mm_loadu_pd(X), Divisor);
+        const __m128d Q = _mm_mul_pd(_mm_set1_pd(2.0 / 3.0), PointX);
+        const __m128d R = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(-1.0 / 3.0), PointX), _mm_mul_pd(_mm_set1_pd(std::sqrt(3.0) / 3.0), PointY));
+        RoundLanes(Q, R, OutQ, OutR);
+    }
+
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON && PLATFORM_64BITS
+    constexpr int Lanes = 2;
+
+    float64x2_t RoundHalfAway(const float64x2_t V)
+    {
+        const uint64x2_t SignBit = vdupq_n_u64(0x8000000000000000ull);
+        const float64x2_t Truncated = vrndq_f64(V);
+        const float64x2_t CutOff = vabsq_f64(vsubq_f64(V, Truncated));
+        const float64x2_t Step = vbslq_f64(SignBit, V, vdupq_n_f64(1.0));
+        const uint64x2_t Away = vcgeq_f64(CutOff, vdupq_n_f64(0.5));
+        return vaddq_f64(Truncated, vreinterpretq_f64_u64(vandq_u64(Away, vreinterpretq_u64_f64(Step))));
+    }
+
+    void RoundLanes(const float64x2_t Q, const float64x2_t R, int32* OutQ, int32* OutR)
+    {
+        const float64x2_t S = vsubq_f64(vnegq_f64(Q), R);
+        const float64x2_t RoundedQ = RoundHalfAway(Q);
+        const float64x2_t RoundedR = RoundHalfAway(R);
+        const float64x2_t RoundedS = RoundHalfAway(S);
+        const float64x2_t QDiff = vabsq_f64(vsubq_f64(RoundedQ, Q));
+        const float64x2_t RDiff = vabsq_f64(vsubq_f64(RoundedR, R));
+        const float64x2_t SDiff = vabsq_f64(vsubq_f64(RoundedS, S));
+
+        const uint64x2_t FixQ = vandq_u64(vcgtq_f64(QDiff, RDiff), vcgtq_f64(QDiff, SDiff));
+        const uint64x2_t FixR = vbicq_u64(vcgtq_f64(RDiff, SDiff), FixQ);
+        const float64x2_t FinalQ = vbslq_f64(FixQ, vsubq_f64(vnegq_f64(RoundedR), RoundedS), RoundedQ);
+        const float64x2_t FinalR = vbslq_f64(FixR, vsubq_f64(vnegq_f64(RoundedQ), RoundedS), RoundedR);
+
+        vst1_s32(OutQ, vmovn_s64(vcvtq_s64_f64(FinalQ)));
+        vst1_s32(OutR, vmovn_s64(vcvtq_s64_f64(FinalR)));
+    }
+
+    void RoundBlock(const double* Q, const double* R, int32* OutQ, int32* OutR)
+    {
+        RoundLanes(vld1q_f64(Q), vld1q_f64(R), OutQ, OutR);
+    }
+
+    void WorldBlock(const double* X, const double* Y, const double Size, int32* OutQ, int32* OutR)
+    {
+        const float64x2_t Divisor = vdupq_n_f64(Size);
+        const float64x2_t PointX = vdivq_f64(vld1q_f64(Y), Divisor);
+        const float64x2_t PointY = vdivq_f64(vld1q_f64(X), Divisor);
+        const float64x2_t Q = vmulq_f64(vdupq_n_f64(2.0 / 3.0), PointX);
+        const float64x2_t R = vaddq_f64(vmulq_f64(vdupq_n_f64(-1.0 / 3.0), PointX), vmulq_f64(vdupq_n_f64(std::sqrt(3.0) / 3.0), PointY));
+        RoundLanes(Q, R, OutQ, OutR);
+    }
+
+#else
+    // No vector path, everything goes through the scalar loop
+    constexpr int Lanes = 0;
+
+    void RoundBlock(const double*, const double*, int32*, int32*) {}
+    void WorldBlock(const double*, const double*, double, int32*, int32*) {}
+#endif
+}
+
+void HexBatchConversion::WorldToHex(const double* X, const double* Y, const int Count, const double OuterTileSize, int32* OutQ, int32* OutR)
+{
+    int i = 0;
+    if (Lanes > 0)
+    {
+        for (; i + Lanes <= Count; i += Lanes)
+        {
+            WorldBlock(X + i, Y + i, OuterTileSize, OutQ + i, OutR + i);
+        }
+    }
+
+    for (; i < Count; i++)
+    {
+        double Q, R;
+        ToFractional(X[i], Y[i], OuterTileSize, Q, R);
+        RoundOne(Q, R, OutQ[i], OutR[i]);
+    }
+}
+
+void HexBatchConversion::HexRound(const double* Q, const double* R, const int Count, int32* OutQ, int32* OutR)
+{
+    int i = 0;
+    if (Lanes > 0)
+    {
+        for (; i + Lanes <= Count; i += Lanes)
+        {
+            RoundBlock(Q + i, R + i, OutQ + i, OutR + i);
+        }
+    }
+
+    for (; i < Count; i++)
+    {
+        RoundOne(Q[i], R[i], OutQ[i], OutR[i]);
+    }
+}
@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Batch versions of AHexGridManager::WorldToHex and Hex::Round over structure of arrays input.
+// Same double precision operations in the same order as the scalar path, so every point lands on the same hex.
+// Runs four points per step with AVX2, two with SSE4.1 or NEON, and the scalar code for the rest.
+class UOCTEST_API HexBatchConversion
+{
+public:
+    // World X/Y of Count points to axial Q/R, OuterTileSize as in AHexGridManager
+    static void WorldToHex(const double* X, const double* Y, int Count, double OuterTileSize, int32* OutQ, int32* OutR);
+
+    // Fractional axial Q/R of Count points to the nearest hex, S is implied
+    static void HexRound(const double* Q, const double* R, int Count, int32* OutQ, int32* OutR);
+};
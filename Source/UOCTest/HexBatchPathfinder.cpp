@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexBatchPathfinder.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "Async/ParallelFor.h"
+
+void HexBatchPathfinder::Solve(const HexTerrain& Terrain, const std::vector<HexPathQuery>& Queries, const std::vector<uint8>& Skip, HexPathBatch& OutBatch,
+    int ThreadCount, const HexSearchSettings& Settings, const HexLandmarks* Landmarks)
+{
+    const int QueryCount = static_cast<int>(Queries.size());
+    OutBatch.Found.assign(QueryCount, 0);
+    OutBatch.Offsets.assign(QueryCount + 1, 0);
+    OutBatch.Hexes.clear();
+    SolvedBy.assign(QueryCount, INDEX_NONE);
+    LocalOffsets.assign(QueryCount, 0);
+
+    if (ThreadCount <= 0)
+    {
+        ThreadCount = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+    }
+
+    const int TaskCount = FMath::Clamp(ThreadCount, 1, FMath::Max(QueryCount, 1));
+    if (static_cast<int>(Workers.size()) < TaskCount)
+    {
+        Workers.resize(TaskCount);
+    }
+
+    // Tasks pull the next query themselves, so long and short paths even out
+    std::atomic<int> NextQuery { 0 };
+    ParallelFor(TaskCount, [&](const int32 Task)
+    {
+        Worker& Scratch = Workers[Task];
+        Scratch.Hexes.clear();
+
+        for (int Query = NextQuery++; Query < QueryCount; Query = NextQuery++)
+        {
+            if (!Skip.empty() && Skip[Query])
+            {
+                continue;
+            }
+
+            const HexPathQuery& Request = Queries[Query];
+            if (!HexPathfinder::FindShortestPath(Terrain, Scratch.Context, Request.Start, Request.End, Scratch.Path, Settings, Landmarks))
+            {
+                continue;
+            }
+
+            OutBatch.Found[Query] = 1;
+            OutBatch.Offsets[Query + 1] = static_cast<int>(Scratch.Path.size());
+            SolvedBy[Query] = Task;
+            LocalOffsets[Query] = static_cast<int>(Scratch.Hexes.size());
+            Scratch.Hexes.insert(Scratch.Hexes.end(), Scratch.Path.begin(), Scratch.Path.end());
+        }
+    }, TaskCount == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+    // Offsets[i + 1] holds the length of path i so far, turn it into a running sum
+    for (int Query = 0; Query < QueryCount; Query++)
+    {
+        OutBatch.Offsets[Query + 1] += OutBatch.Offsets[Query];
+    }
+
+    OutBatch.Hexes.resize(OutBatch.Offsets[QueryCount]);
+    for (int Query = 0; Query < QueryCount; Query++)
+    {
+        if (SolvedBy[Query] != INDEX_NONE)
+        {
+            const Hex* Source = Workers[SolvedBy[Query]].Hexes.data() + LocalOffsets[Query];
+            std::copy(Source, Source + OutBatch.GetPathLength(Query), OutBatch.Hexes.begin() + OutBatch.Offsets[Query]);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexPathfinder.h"
+#include "HexTerrain.h"
+
+struct HexPathQuery
+{
+    Hex Start;
+    Hex End;
+};
+
+// Paths of a batch stored back to back, path i is Hexes[Offsets[i], Offsets[i + 1])
+struct UOCTEST_API HexPathBatch
+{
+    int Num() const { return static_cast<int>(Found.size()); }
+
+    bool WasFound(const int Query) const { return Found[Query] != 0; }
+
+    const Hex* GetPath(const int Query) const { return Hexes.data() + Offsets[Query]; }
+    int GetPathLength(const int Query) const { return Offsets[Query + 1] - Offsets[Query]; }
+
+    std::vector<Hex> Hexes;
+    std::vector<int> Offsets;
+    std::vector<uint8> Found;
+};
+
+// Solves many independent queries in parallel. Every task keeps its own search context and
+// path buffers between batches, so a warmed up batch only writes into existing memory.
+class UOCTEST_API HexBatchPathfinder
+{
+public:
+    // Skip may be empty, otherwise queries with a non zero entry are reported as not found.
+    // ThreadCount 0 uses all task graph workers plus the calling thread.
+    void Solve(const HexTerrain& Terrain, const std::vector<HexPathQuery>& Queries, const std::vector<uint8>& Skip, HexPathBatch& OutBatch,
+        int ThreadCount = 0, const HexSearchSettings& Settings = HexSearchSettings(), const HexLandmarks* Landmarks = nullptr);
+
+private:
+    struct Worker
+    {
+        HexSearchContext Context;
+        std::vector<Hex> Path;
+
+        // Paths solved by this worker, back to back
+        std::vector<Hex> Hexes;
+    };
+
+    std::vector<Worker> Workers;
+
+    // Per query, where its path sits in the buffer of the worker that solved it
+    std::vector<int> SolvedBy;
+    std::vector<int> LocalOffsets;
+};
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexBucketQueue.h"
+
+void HexBucketQueue::Reset()
+{
+    for (int Key = Cursor; Key <= MaxKey; Key++)
+    {
+        Buckets[Key].Preferred.clear();
+        Buckets[Key].Normal.clear();
+    }
+
+    Cursor = 0;
+    MaxKey = -1;
+    Count = 0;
+}
+
+void HexBucketQueue::Push(const int Index, int Key, const bool Preferred)
+{
+    Key = FMath::Max(Key, 0);
+    if (Key >= static_cast<int>(Buckets.size()))
+    {
+        Buckets.resize(Key + 1);
+    }
+
+    Bucket& Target = Buckets[Key];
+    if (Preferred)
+    {
+        Target.Preferred.push_back(Index);
+    }
+    else
+    {
+        Target.Normal.push_back(Index);
+    }
+
+    if (Count == 0 || Key < Cursor)
+    {
+        Cursor = Key;
+    }
+    MaxKey = FMath::Max(MaxKey, Key);
+    Count++;
+}
+
+int HexBucketQueue::Pop()
+{
+    while (Buckets[Cursor].Preferred.empty() && Buckets[Cursor].Normal.empty())
+    {
+        Cursor++;
+    }
+
+    std::vector<int>& Entries = Buckets[Cursor].Preferred.empty() ? Buckets[Cursor].Normal : Buckets[Cursor].Preferred;
+    const int Index = Entries.back();
+    Entries.pop_back();
+    Count--;
+
+    return Index;
+}
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+
+// Dial style bucket queue for small integer keys, push and pop are O(1) amortized.
+// Keys mostly grow during a search; a key below the cursor just moves the cursor back.
+// Inside a bucket, preferred entries come out first, which gives searches a deterministic
+// tie-break without fractional cost nudges.
+struct UOCTEST_API HexBucketQueue
+{
+    // Empties the queue, buckets keep their memory for the next search
+    void Reset();
+
+    void Push(int Index, int Key, bool Preferred);
+
+    int Pop();
+
+    bool IsEmpty() const { return Count == 0; }
+
+private:
+    struct Bucket
+    {
+        std::vector<int> Preferred;
+        std::vector<int> Normal;
+    };
+
+    std::vector<Bucket> Buckets;
+
+    // No bucket below the cursor holds entries
+    int Cursor = 0;
+    int MaxKey = -1;
+    int Count = 0;
+};
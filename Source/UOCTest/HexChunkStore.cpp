@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexChunkStore.h"
+
+#include "HexRunLength.h"
+
+namespace
+{
+    // Rounds towards negative infinity, chunk -1 holds columns -ChunkSize..-1
+    int FloorDiv(const int A, const int B)
+    {
+        return A >= 0 ? A / B : -((-A + B - 1) / B);
+    }
+}
+
+void HexChunkStore::Init(const int InChunkSize, const int InMaxResidentChunks, ChunkGenerator InGenerator)
+{
+    ChunkSize = FMath::Max(InChunkSize, 1);
+    MaxResidentChunks = FMath::Max(InMaxResidentChunks, 1);
+    Generator = MoveTemp(InGenerator);
+
+    Resident.clear();
+    ResidentSlots.Reset();
+    EditedChunks.Reset();
+    EditedBytes = 0;
+    Clock = 0;
+}
+
+HexKey HexChunkStore::ChunkOf(const Hex& H) const
+{
+    const int Column = H.Q;
+    const int Row = H.R + HexGridLayout::QOffset(H.Q);
+    return HexKey(FloorDiv(Column, ChunkSize), FloorDiv(Row, ChunkSize));
+}
+
+HexGridLayout HexChunkStore::GetChunkLayout(const HexKey Chunk) const
+{
+    return GetChunkLayout(Chunk, Chunk);
+}
+
+HexGridLayout HexChunkStore::GetChunkLayout(const HexKey MinChunk, const HexKey MaxChunk) const
+{
+    return HexGridLayout(MinChunk.GetQ() * ChunkSize, (MaxChunk.GetQ() + 1) * ChunkSize - 1,
+        MinChunk.GetR() * ChunkSize, (MaxChunk.GetR() + 1) * ChunkSize - 1);
+}
+
+const EHexTypes* HexChunkStore::Acquire(const HexKey Chunk)
+{
+    return Resident[Load(Chunk)].Types.data();
+}
+
+EHexTypes HexChunkStore::GetType(const Hex& H)
+{
+    const HexKey Chunk = ChunkOf(H);
+    return Acquire(Chunk)[GetChunkLayout(Chunk).IndexOf(H)];
+}
+
+void HexChunkStore::SetType(const Hex& H, const EHexTypes Type)
+{
+    const HexKey Chunk = ChunkOf(H);
+    ResidentChunk& Loaded = Resident[Load(Chunk)];
+    Loaded.Types[GetChunkLayout(Chunk).IndexOf(H)] = Type;
+    Loaded.Edited = true;
+}
+
+int HexChunkStore::Load(const HexKey Chunk)
+{
+    Clock++;
+
+    if (const int* Slot = ResidentSlots.Find(Chunk))
+    {
+        Resident[*Slot].LastUsed = Clock;
+        return *Slot;
+    }
+
+    // Take a free slot or the least recently used one
+    int Slot = static_cast<int>(Resident.size());
+    if (Slot < MaxResidentChunks)
+    {
+        Resident.emplace_back();
+    }
+    else
+    {
+        Slot = 0;
+        for (int i = 1; i < static_cast<int>(Resident.size()); i++)
+        {
+            if (Resident[i].LastUsed < Resident[Slot].LastUsed)
+            {
+                Slot = i;
+            }
+        }
+
+        ResidentChunk& Evicted = Resident[Slot];
+        if (Evicted.Edited)
+        {
+            std::vector<uint8>& Bytes = EditedChunks.FindOrAdd(Evicted.Key);
+            EditedBytes -= static_cast<int64>(Bytes.size());
+            Bytes.resize(HexRunLength::MaxEncodedBytes(static_cast<int>(Evicted.Types.size())));
+            Bytes.resize(HexRunLength::Encode(Evicted.Types.data(), static_cast<int>(Evicted.Types.size()), Bytes.data()));
+            Bytes.shrink_to_fit();
+            EditedBytes += static_cast<int64>(Bytes.size());
+        }
+        ResidentSlots.Remove(Evicted.Key);
+    }
+
+    ResidentChunk& Loaded = Resident[Slot];
+    Loaded.Key = Chunk;
+    Loaded.LastUsed = Clock;
+    Loaded.Types.resize(ChunkSize * ChunkSize);
+
+    if (const std::vector<uint8>* Bytes = EditedChunks.Find(Chunk))
+    {
+        // Back in memory, the encoded copy is written again on the next eviction
+        verify(HexRunLength::Decode(Bytes->data(), static_cast<int64>(Bytes->size()), Loaded.Types.data(), static_cast<int>(Loaded.Types.size())));
+        EditedBytes -= static_cast<int64>(Bytes->size());
+        EditedChunks.Remove(Chunk);
+        Loaded.Edited = true;
+    }
+    else
+    {
+        std::fill(Loaded.Types.begin(), Loaded.Types.end(), EHexTypes::Grass);
+        if (Generator)
+        {
+            Generator(GetChunkLayout(Chunk), Loaded.Types.data());
+        }
+        Loaded.Edited = false;
+    }
+
+    ResidentSlots.FindOrAdd(Chunk) = Slot;
+    return Slot;
+}
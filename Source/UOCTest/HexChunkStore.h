@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexEnum.h"
+#include "HexGridStorage.h"
+#include "HexKey.h"
+#include "HexKeyMap.h"
+
+// Terrain types of an unbounded world, split into square chunks of the grid layout.
+// A chunk is generated on first use and only a bounded number of them stay resident. Evicting
+// an edited chunk keeps it run length encoded, so memory grows with edits, not with the world.
+class UOCTEST_API HexChunkStore
+{
+public:
+    // Fills the types of a chunk that was never edited, ChunkLayout covers exactly the chunk
+    typedef TFunction<void(const HexGridLayout& ChunkLayout, EHexTypes* OutTypes)> ChunkGenerator;
+
+    void Init(int InChunkSize, int InMaxResidentChunks, ChunkGenerator InGenerator);
+
+    int GetChunkSize() const { return ChunkSize; }
+
+    int GetMaxResidentChunks() const { return MaxResidentChunks; }
+
+    // Chunk coordinates, X along columns and Y along rows of the layout
+    HexKey ChunkOf(const Hex& H) const;
+
+    // Layout of a single chunk, and of the rectangle of chunks between Min and Max inclusive
+    HexGridLayout GetChunkLayout(HexKey Chunk) const;
+    HexGridLayout GetChunkLayout(HexKey MinChunk, HexKey MaxChunk) const;
+
+    // Types of a chunk in its layout order. Loads the chunk, the pointer is valid until the next Acquire.
+    const EHexTypes* Acquire(HexKey Chunk);
+
+    EHexTypes GetType(const Hex& H);
+    void SetType(const Hex& H, EHexTypes Type);
+
+    int GetResidentCount() const { return static_cast<int>(Resident.size()); }
+
+    // Bytes held by evicted edited chunks
+    int64 GetEditedBytes() const { return EditedBytes; }
+
+private:
+    struct ResidentChunk
+    {
+        HexKey Key;
+        std::vector<EHexTypes> Types;
+        uint32 LastUsed = 0;
+
+        // Differs from what the generator makes
+        bool Edited = false;
+    };
+
+    // Returns the slot of a resident chunk, loading it and evicting the oldest one when needed
+    int Load(HexKey Chunk);
+
+    int ChunkSize = 32;
+    int MaxResidentChunks = 64;
+    ChunkGenerator Generator;
+
+    std::vector<ResidentChunk> Resident;
+    HexKeyMap<int> ResidentSlots;
+    uint32 Clock = 0;
+
+    // HexRunLength runs of the chunks evicted with edits
+    HexKeyMap<std::vector<uint8>> EditedChunks;
+    int64 EditedBytes = 0;
+};
@@ -0,0 +1,416 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexClusterGraph.h"
+
+#include <algorithm>
+
+#include "Hex.h"
+
+namespace
+{
+    const float Unreachable = TNumericLimits<float>::Max();
+}
+
+void HexClusterGraph::Build(const HexTerrain* InTerrain, const int InClusterSize, const float InMinTileCost)
+{
+    Terrain = InTerrain;
+    ClusterSize = FMath::Max(InClusterSize, 2);
+    MinTileCost = InMinTileCost;
+
+    const HexGridLayout& Layout = Terrain->GetLayout();
+    ClusterColumns = (Layout.Width + ClusterSize - 1) / ClusterSize;
+    ClusterRows = (Layout.Height + ClusterSize - 1) / ClusterSize;
+
+    Clusters.assign(ClusterColumns * ClusterRows, Cluster());
+    EntranceSlot.assign(Terrain->Num(), INDEX_NONE);
+
+    for (int ClusterIndex = 0; ClusterIndex < static_cast<int>(Clusters.size()); ClusterIndex++)
+    {
+        Cluster& C = Clusters[ClusterIndex];
+        C.FirstColumn = ClusterIndex / ClusterRows * ClusterSize;
+        C.EndColumn = FMath::Min(C.FirstColumn + ClusterSize, Layout.Width);
+        C.FirstRow = ClusterIndex % ClusterRows * ClusterSize;
+        C.EndRow = FMath::Min(C.FirstRow + ClusterSize, Layout.Height);
+    }
+
+    // Borders with the clusters to the right and below, diagonals included
+    for (int ClusterIndex = 0; ClusterIndex < static_cast<int>(Clusters.size()); ClusterIndex++)
+    {
+        const int Column = ClusterIndex / ClusterRows;
+        const int Row = ClusterIndex % ClusterRows;
+        const int Others[] = {
+            Row + 1 < ClusterRows ? ClusterIndex + 1 : INDEX_NONE,
+            Column + 1 < ClusterColumns ? ClusterIndex + ClusterRows : INDEX_NONE,
+            Column + 1 < ClusterColumns && Row + 1 < ClusterRows ? ClusterIndex + ClusterRows + 1 : INDEX_NONE,
+            Column + 1 < ClusterColumns && Row > 0 ? ClusterIndex + ClusterRows - 1 : INDEX_NONE,
+        };
+
+        for (const int Other : Others)
+        {
+            if (Other != INDEX_NONE)
+            {
+                BuildBorder(ClusterIndex, Other);
+            }
+        }
+    }
+
+    for (int ClusterIndex = 0; ClusterIndex < static_cast<int>(Clusters.size()); ClusterIndex++)
+    {
+        BuildEntrances(ClusterIndex);
+    }
+}
+
+void HexClusterGraph::OnTileChanged(const int Index)
+{
+    if (!Terrain || Index < 0 || Index >= static_cast<int>(EntranceSlot.size()))
+    {
+        return;
+    }
+
+    const int Owner = ClusterOf(Index);
+
+    // A border tile can move the entrances of the clusters next to it
+    int Touched[6];
+    int TouchedCount = 0;
+    for (const int Next : HexNeighbors(Terrain->GetLayout(), Index))
+    {
+        const int Other = ClusterOf(Next);
+        if (Other != Owner && std::find(Touched, Touched + TouchedCount, Other) == Touched + TouchedCount)
+        {
+            Touched[TouchedCount++] = Other;
+        }
+    }
+
+    for (int i = 0; i < TouchedCount; i++)
+    {
+        BuildBorder(FMath::Min(Owner, Touched[i]), FMath::Max(Owner, Touched[i]));
+    }
+
+    BuildEntrances(Owner);
+    for (int i = 0; i < TouchedCount; i++)
+    {
+        BuildEntrances(Touched[i]);
+    }
+}
+
+bool HexClusterGraph::FindPath(const Hex& Start, const Hex& End, std::vector<Hex>& OutPath)
+{
+    OutPath.clear();
+    NodesExpanded = 0;
+
+    if (!Terrain)
+    {
+        return false;
+    }
+
+    const HexGridLayout& Layout = Terrain->GetLayout();
+    const int StartIndex = Layout.IndexOf(Start);
+    const int EndIndex = Layout.IndexOf(End);
+    if (StartIndex == INDEX_NONE || EndIndex == INDEX_NONE || !Terrain->IsPassable(EndIndex))
+    {
+        return false;
+    }
+
+    if (StartIndex == EndIndex)
+    {
+        OutPath.push_back(Start);
+        return true;
+    }
+
+    const int StartCluster = ClusterOf(StartIndex);
+    const int EndCluster = ClusterOf(EndIndex);
+
+    // Short queries inside one cluster don't need the abstract graph
+    if (StartCluster == EndCluster)
+    {
+        OutPath.push_back(Start);
+        if (AppendClusterPath(StartCluster, StartIndex, EndIndex, OutPath))
+        {
+            return true;
+        }
+        OutPath.clear();
+    }
+
+    // Connect Start and End to the entrances of their clusters
+    const std::vector<int>& StartEntrances = Clusters[StartCluster].Entrances;
+    SearchCluster(StartCluster, StartIndex, INDEX_NONE, false);
+    StartCosts.clear();
+    for (const int Entrance : StartEntrances)
+    {
+        StartCosts.push_back(LocalContext.IsReached(Entrance) ? static_cast<float>(LocalContext.GetCost(Entrance)) : Unreachable);
+    }
+
+    const std::vector<int>& EndEntrances = Clusters[EndCluster].Entrances;
+    SearchCluster(EndCluster, EndIndex, INDEX_NONE, true);
+    EndCosts.clear();
+    for (const int Entrance : EndEntrances)
+    {
+        EndCosts.push_back(LocalContext.IsReached(Entrance) ? static_cast<float>(LocalContext.GetCost(Entrance)) : Unreachable);
+    }
+
+    // A* over the abstract graph, nodes are the entrance tiles plus Start and End
+    AbstractContext.Begin(Terrain->Num());
+    AbstractContext.Reach(StartIndex, 0, StartIndex);
+    AbstractContext.Push(StartIndex, 0);
+
+    bool Found = false;
+    while (!AbstractContext.IsOpenEmpty())
+    {
+        const int Current = AbstractContext.Pop();
+        NodesExpanded++;
+
+        if (Current == EndIndex)
+        {
+            Found = true;
+            break;
+        }
+
+        const double CurrentCost = AbstractContext.GetCost(Current);
+        auto Relax = [&](const int Next, const float EdgeCost)
+        {
+            if (EdgeCost >= Unreachable)
+            {
+                return;
+            }
+
+            const double NewCost = CurrentCost + EdgeCost;
+            if (!AbstractContext.IsReached(Next) || NewCost < AbstractContext.GetCost(Next))
+            {
+                AbstractContext.Reach(Next, NewCost, Current);
+                AbstractContext.Push(Next, NewCost + Hex::Distance(Layout.HexAt(Next), End) * MinTileCost);
+            }
+        };
+
+        if (Current == StartIndex)
+        {
+            for (int i = 0; i < static_cast<int>(StartEntrances.size()); i++)
+            {
+                Relax(StartEntrances[i], StartCosts[i]);
+            }
+        }
+
+        const int Slot = EntranceSlot[Current];
+        if (Slot == INDEX_NONE)
+        {
+            continue;
+        }
+
+        const int CurrentCluster = ClusterOf(Current);
+        const Cluster& C = Clusters[CurrentCluster];
+        const int EntranceCount = static_cast<int>(C.Entrances.size());
+        for (int i = 0; i < EntranceCount; i++)
+        {
+            if (i != Slot)
+            {
+                Relax(C.Entrances[i], C.Costs[Slot * EntranceCount + i]);
+            }
+        }
+
+        for (const Transition& T : C.Transitions)
+        {
+            if (T.Local == Current)
+            {
+                Relax(T.Remote, Terrain->GetCost(T.Remote));
+            }
+        }
+
+        if (CurrentCluster == EndCluster)
+        {
+            Relax(EndIndex, EndCosts[Slot]);
+        }
+    }
+
+    if (!Found)
+    {
+        return false; // no path can be found
+    }
+
+    AbstractPath.clear();
+    for (int Current = EndIndex; Current != StartIndex; Current = AbstractContext.GetCameFrom(Current))
+    {
+        AbstractPath.push_back(Current);
+    }
+    AbstractPath.push_back(StartIndex);
+    std::reverse(AbstractPath.begin(), AbstractPath.end());
+
+    // Refine only the corridor, transitions are single steps between neighbors
+    OutPath.push_back(Start);
+    for (int i = 1; i < static_cast<int>(AbstractPath.size()); i++)
+    {
+        const int From = AbstractPath[i - 1];
+        const int To = AbstractPath[i];
+        const int FromCluster = ClusterOf(From);
+        if (FromCluster != ClusterOf(To))
+        {
+            OutPath.push_back(Layout.HexAt(To));
+        }
+        else if (!AppendClusterPath(FromCluster, From, To, OutPath))
+        {
+            OutPath.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int HexClusterGraph::ClusterOf(const int Index) const
+{
+    const int Height = Terrain->GetLayout().Height;
+    return Index / Height / ClusterSize * ClusterRows + Index % Height / ClusterSize;
+}
+
+void HexClusterGraph::BuildBorder(const int A, const int B)
+{
+    auto RemoveTransitions = [](Cluster& C, const int Other)
+    {
+        C.Transitions.erase(
+            std::remove_if(C.Transitions.begin(), C.Transitions.end(), [Other](const Transition& T) { return T.RemoteCluster == Other; }),
+            C.Transitions.end());
+    };
+    RemoveTransitions(Clusters[A], B);
+    RemoveTransitions(Clusters[B], A);
+
+    // Passable neighbor pairs along the border, in layout order
+    const HexGridLayout& Layout = Terrain->GetLayout();
+    const Cluster& C = Clusters[A];
+    Candidates.clear();
+    for (int Column = C.FirstColumn; Column < C.EndColumn; Column++)
+    {
+        for (int Row = C.FirstRow; Row < C.EndRow; Row++)
+        {
+            const int Index = Column * Layout.Height + Row;
+            if (!Terrain->IsPassable(Index))
+            {
+                continue;
+            }
+
+            for (const int Next : HexNeighbors(Layout, Index))
+            {
+                if (ClusterOf(Next) == B && Terrain->IsPassable(Next))
+                {
+                    Candidates.emplace_back(Index, Next);
+                }
+            }
+        }
+    }
+
+    // One transition in the middle of every run that is connected on both sides. A blocked tile
+    // on the remote side alone splits the run, the middle transition may not reach the other part.
+    int RunStart = 0;
+    for (int i = 1; i <= static_cast<int>(Candidates.size()); i++)
+    {
+        if (i < static_cast<int>(Candidates.size()))
+        {
+            const std::pair<int, int>& Previous = Candidates[i - 1];
+            const std::pair<int, int>& Current = Candidates[i];
+            if (Hex::Distance(Layout.HexAt(Previous.first), Layout.HexAt(Current.first)) <= 1 &&
+                Hex::Distance(Layout.HexAt(Previous.second), Layout.HexAt(Current.second)) <= 1)
+            {
+                continue;
+            }
+        }
+
+        const std::pair<int, int>& Middle = Candidates[(RunStart + i - 1) / 2];
+        Clusters[A].Transitions.push_back(Transition{ Middle.first, Middle.second, B });
+        Clusters[B].Transitions.push_back(Transition{ Middle.second, Middle.first, A });
+        RunStart = i;
+    }
+}
+
+void HexClusterGraph::BuildEntrances(const int ClusterIndex)
+{
+    Cluster& C = Clusters[ClusterIndex];
+
+    for (const int Entrance : C.Entrances)
+    {
+        EntranceSlot[Entrance] = INDEX_NONE;
+    }
+
+    C.Entrances.clear();
+    for (const Transition& T : C.Transitions)
+    {
+        C.Entrances.push_back(T.Local);
+    }
+    std::sort(C.Entrances.begin(), C.Entrances.end());
+    C.Entrances.erase(std::unique(C.Entrances.begin(), C.Entrances.end()), C.Entrances.end());
+
+    const int EntranceCount = static_cast<int>(C.Entrances.size());
+    for (int i = 0; i < EntranceCount; i++)
+    {
+        EntranceSlot[C.Entrances[i]] = i;
+    }
+
+    C.Costs.assign(EntranceCount * EntranceCount, Unreachable);
+    for (int i = 0; i < EntranceCount; i++)
+    {
+        SearchCluster(ClusterIndex, C.Entrances[i], INDEX_NONE, false);
+        for (int j = 0; j < EntranceCount; j++)
+        {
+            if (LocalContext.IsReached(C.Entrances[j]))
+            {
+                C.Costs[i * EntranceCount + j] = static_cast<float>(LocalContext.GetCost(C.Entrances[j]));
+            }
+        }
+    }
+}
+
+void HexClusterGraph::SearchCluster(const int ClusterIndex, const int Source, const int Target, const bool Reverse)
+{
+    const HexGridLayout& Layout = Terrain->GetLayout();
+
+    LocalContext.Begin(Terrain->Num());
+    LocalContext.Reach(Source, 0, Source);
+    LocalContext.Push(Source, 0);
+
+    while (!LocalContext.IsOpenEmpty())
+    {
+        const int Current = LocalContext.Pop();
+        NodesExpanded++;
+
+        if (Current == Target)
+        {
+            break;
+        }
+
+        for (const int Next : HexNeighbors(Layout, Current))
+        {
+            if (ClusterOf(Next) != ClusterIndex || !Terrain->IsPassable(Next))
+            {
+                continue;
+            }
+
+            // Reverse steps go from Next into Current, so they pay for Current
+            const double NewCost = LocalContext.GetCost(Current) + Terrain->GetCost(Reverse ? Current : Next);
+            if (!LocalContext.IsReached(Next) || NewCost < LocalContext.GetCost(Next))
+            {
+                LocalContext.Reach(Next, NewCost, Current);
+                LocalContext.Push(Next, NewCost);
+            }
+        }
+    }
+}
+
+bool HexClusterGraph::AppendClusterPath(const int ClusterIndex, const int From, const int To, std::vector<Hex>& OutPath)
+{
+    SearchCluster(ClusterIndex, From, To, false);
+    if (!LocalContext.IsReached(To))
+    {
+        return false;
+    }
+
+    LocalPath.clear();
+    for (int Current = To; Current != From; Current = LocalContext.GetCameFrom(Current))
+    {
+        LocalPath.push_back(Current);
+    }
+
+    const HexGridLayout& Layout = Terrain->GetLayout();
+    for (auto It = LocalPath.rbegin(); It != LocalPath.rend(); ++It)
+    {
+        OutPath.push_back(Layout.HexAt(*It));
+    }
+
+    return true;
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexPathfinder.h"
+#include "HexTerrain.h"
+
+// Hierarchical pathfinding (HPA*). The grid is split into square blocks of the layout, every
+// border run between two blocks gets an entrance pair and the costs between entrances of a block
+// are precomputed. Queries search the small abstract graph first and then refine only the
+// blocks along the found corridor.
+class UOCTEST_API HexClusterGraph
+{
+public:
+    void Build(const HexTerrain* InTerrain, int InClusterSize, float InMinTileCost);
+
+    // Rebuilds the cluster that owns the tile, and the borders it shares when the tile sits on one
+    void OnTileChanged(int Index);
+
+    // Writes Start..End into OutPath, returns false when End can't be reached
+    bool FindPath(const Hex& Start, const Hex& End, std::vector<Hex>& OutPath);
+
+    int GetClusterCount() const { return static_cast<int>(Clusters.size()); }
+
+    // Number of abstract and local nodes expanded by the last FindPath
+    int NodesExpanded = 0;
+
+private:
+    // Crossing from Local in this cluster to Remote in RemoteCluster
+    struct Transition
+    {
+        int Local;
+        int Remote;
+        int RemoteCluster;
+    };
+
+    struct Cluster
+    {
+        int FirstColumn = 0;
+        int EndColumn = 0;
+        int FirstRow = 0;
+        int EndRow = 0;
+
+        std::vector<Transition> Transitions;
+
+        // Tiles that take part in a transition
+        std::vector<int> Entrances;
+
+        // Entrances.size() squared, row is the entrance the path starts from
+        std::vector<float> Costs;
+    };
+
+    int ClusterOf(int Index) const;
+
+    // Recomputes the transitions between two clusters
+    void BuildBorder(int A, int B);
+
+    // Recomputes entrances and the cost matrix of a cluster
+    void BuildEntrances(int ClusterIndex);
+
+    // Dijkstra limited to one cluster, results stay in LocalContext. Reverse computes the cost
+    // from every tile to Source instead of from Source to every tile.
+    void SearchCluster(int ClusterIndex, int Source, int Target, bool Reverse);
+
+    // Appends the tiles after From up to To, using a search limited to the cluster
+    bool AppendClusterPath(int ClusterIndex, int From, int To, std::vector<Hex>& OutPath);
+
+    const HexTerrain* Terrain = nullptr;
+    int ClusterSize = 10;
+    int ClusterColumns = 0;
+    int ClusterRows = 0;
+    float MinTileCost = 1.f;
+
+    std::vector<Cluster> Clusters;
+
+    // Position of a tile in the Entrances of its cluster, INDEX_NONE for other tiles
+    std::vector<int> EntranceSlot;
+
+    HexSearchContext LocalContext;
+    HexSearchContext AbstractContext;
+
+    // Scratch buffers reused between queries
+    std::vector<std::pair<int, int>> Candidates;
+    std::vector<float> StartCosts;
+    std::vector<float> EndCosts;
+    std::vector<int> AbstractPath;
+    std::vector<int> LocalPath;
+};
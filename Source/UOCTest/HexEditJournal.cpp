@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexEditJournal.h"
+
+#include <algorithm>
+
+void HexEditJournal::Init(const int InMaxTransactions)
+{
+    MaxTransactions = FMath::Max(InMaxTransactions, 1);
+    Clear();
+}
+
+void HexEditJournal::Begin()
+{
+    Depth++;
+}
+
+const std::vector<HexTileEdit>* HexEditJournal::End()
+{
+    if (Depth == 0 || --Depth > 0)
+    {
+        return nullptr;
+    }
+
+    // Tiles painted back to what they were aren't changes
+    Open.erase(std::remove_if(Open.begin(), Open.end(), [](const HexTileEdit& Edit) { return Edit.OldType == Edit.NewType; }), Open.end());
+    OpenSlots.Reset();
+
+    if (Open.empty())
+    {
+        return nullptr;
+    }
+
+    // A new change makes the undone transactions unreachable
+    Transactions.resize(Cursor);
+    if (static_cast<int>(Transactions.size()) == MaxTransactions)
+    {
+        Transactions.erase(Transactions.begin());
+    }
+
+    Transactions.push_back(std::move(Open));
+    Transactions.back().shrink_to_fit();
+    Cursor = static_cast<int>(Transactions.size());
+    Open = std::vector<HexTileEdit>();
+    return &Transactions.back();
+}
+
+void HexEditJournal::Record(const Hex& Tile, const EHexTypes OldType, const EHexTypes NewType)
+{
+    const HexKey Key(Tile);
+    if (int* Slot = OpenSlots.Find(Key))
+    {
+        Open[*Slot].NewType = NewType;
+        return;
+    }
+
+    OpenSlots.FindOrAdd(Key) = static_cast<int>(Open.size());
+    Open.push_back(HexTileEdit { Key, OldType, NewType });
+}
+
+const std::vector<HexTileEdit>* HexEditJournal::Undo()
+{
+    return CanUndo() ? &Transactions[--Cursor] : nullptr;
+}
+
+const std::vector<HexTileEdit>* HexEditJournal::Redo()
+{
+    return CanRedo() ? &Transactions[Cursor++] : nullptr;
+}
+
+void HexEditJournal::Clear()
+{
+    Transactions.clear();
+    Cursor = 0;
+    Depth = 0;
+    Open.clear();
+    OpenSlots.Reset();
+}
+
+int64 HexEditJournal::GetAllocatedBytes() const
+{
+    int64 Bytes = 0;
+    for (const std::vector<HexTileEdit>& Transaction : Transactions)
+    {
+        Bytes += static_cast<int64>(Transaction.capacity() * sizeof(HexTileEdit));
+    }
+
+    return Bytes;
+}
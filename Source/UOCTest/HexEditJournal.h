@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexEnum.h"
+#include "HexKey.h"
+#include "HexKeyMap.h"
+
+// One tile type change, 16 bytes
+struct HexTileEdit
+{
+    HexKey Tile;
+    EHexTypes OldType = EHexTypes::Invalid;
+    EHexTypes NewType = EHexTypes::Invalid;
+};
+
+// Undo history of tile type changes. Edits are grouped into transactions, a whole brush stroke undoes at once.
+// Inside a transaction every tile keeps a single entry, painting over it again only moves its new type.
+class UOCTEST_API HexEditJournal
+{
+public:
+    // Oldest transactions are dropped past this
+    void Init(int InMaxTransactions);
+
+    // Transactions nest, only the outermost End commits
+    void Begin();
+
+    // Returns the committed transaction, nullptr while an outer one is still open or when nothing changed
+    const std::vector<HexTileEdit>* End();
+
+    bool IsRecording() const { return Depth > 0; }
+
+    // Called with the type before the first change of Tile in this transaction
+    void Record(const Hex& Tile, EHexTypes OldType, EHexTypes NewType);
+
+    // Entries of the open transaction
+    const std::vector<HexTileEdit>& GetOpenEdits() const { return Open; }
+
+    bool CanUndo() const { return Cursor > 0; }
+    bool CanRedo() const { return Cursor < static_cast<int>(Transactions.size()); }
+
+    // Steps back over a transaction and returns its entries, the caller applies their OldType
+    const std::vector<HexTileEdit>* Undo();
+
+    // Steps forward over a transaction and returns its entries, the caller applies their NewType
+    const std::vector<HexTileEdit>* Redo();
+
+    void Clear();
+
+    // Bytes held by committed transactions
+    int64 GetAllocatedBytes() const;
+
+private:
+    std::vector<std::vector<HexTileEdit>> Transactions;
+
+    // Transactions before Cursor are done, the ones after it were undone
+    int Cursor = 0;
+
+    int MaxTransactions = 64;
+    int Depth = 0;
+
+    std::vector<HexTileEdit> Open;
+
+    // Entry in Open of every tile changed in the open transaction
+    HexKeyMap<int> OpenSlots;
+};
@@ -11,4 +11,34 @@ enum class EHexTypes : uint8
 	Dirt,
 	Blocked,
     MAX
+};
+
+UENUM(BlueprintType)
+enum class EHexRenderMode : uint8
+{
+	// One AHexTile actor per hex
+	Actors,
+	// One instanced mesh for the whole grid, type and selection live in per-instance custom data
+	Instanced,
+};
+
+UENUM(BlueprintType)
+enum class EHexGridBuildStage : uint8
+{
+	NotStarted,
+	// Transforms and types are computed on worker threads, queries fail
+	Preparing,
+	// Terrain is final, tiles are registered for rendering a batch per frame
+	Registering,
+	Ready,
+};
+
+UENUM(BlueprintType)
+enum class EHexMapCompression : uint8
+{
+	// Chunks are stored as type bytes and copied out of the mapped file
+	None,
+	// (count, type) byte pairs, best for large areas of one type
+	RLE,
+	LZ4,
 };
\ No newline at end of file
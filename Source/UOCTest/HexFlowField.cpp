@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexFlowField.h"
+
+void HexFlowField::Build(const HexTerrain& Terrain, const int InGoalIndex, HexSearchContext& Context)
+{
+    Layout = Terrain.GetLayout();
+    GoalIndex = InGoalIndex;
+    Dirty = false;
+
+    Directions.assign(Terrain.Num(), NoDirection);
+    Costs.assign(Terrain.Num(), TNumericLimits<float>::Max());
+
+    if (GoalIndex == INDEX_NONE || !Terrain.IsPassable(GoalIndex))
+    {
+        return;
+    }
+
+    // Dijkstra from the goal, stepping from a tile into Current costs Current
+    Context.Begin(Terrain.Num());
+    Costs[GoalIndex] = 0.f;
+    Context.Push(GoalIndex, 0.f);
+
+    while (!Context.IsOpenEmpty())
+    {
+        const int Current = Context.Pop();
+
+        // The heap keeps outdated entries, only the first pop of a tile carries its final cost
+        if (Context.IsReached(Current))
+        {
+            continue;
+        }
+        Context.Reach(Current, Costs[Current], INDEX_NONE);
+        Context.NodesExpanded++;
+
+        const Hex CurrentHex = Layout.HexAt(Current);
+        const float NewCost = Costs[Current] + Terrain.GetCost(Current);
+        for (int Direction = 0; Direction < 6; Direction++)
+        {
+            const int Next = Layout.IndexOf(CurrentHex.Q + HexGridLayout::DirectionQ[Direction], CurrentHex.R + HexGridLayout::DirectionR[Direction]);
+            if (Next == INDEX_NONE || Context.IsReached(Next) || !Terrain.IsPassable(Next) || NewCost >= Costs[Next])
+            {
+                continue;
+            }
+
+            // Opposite direction leads back towards Current
+            Costs[Next] = NewCost;
+            Directions[Next] = static_cast<uint8>((Direction + 3) % 6);
+            Context.Push(Next, NewCost);
+        }
+    }
+}
+
+bool HexFlowField::GetNextHex(const Hex& From, Hex& OutNext) const
+{
+    const int Index = Layout.IndexOf(From);
+    if (Index == INDEX_NONE || Directions[Index] == NoDirection)
+    {
+        return false;
+    }
+
+    const uint8 Direction = Directions[Index];
+    OutNext = Hex(From.Q + HexGridLayout::DirectionQ[Direction], From.R + HexGridLayout::DirectionR[Direction]);
+    return true;
+}
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexPathfinder.h"
+#include "HexTerrain.h"
+
+// Result of one Dijkstra pass from a goal. Every tile stores the direction of its next step,
+// so any number of units heading to the same goal can read their move in O(1).
+struct UOCTEST_API HexFlowField
+{
+    static constexpr uint8 NoDirection = 0xFF;
+
+    // Context provides the open list and marks finished tiles, the field keeps its own arrays
+    void Build(const HexTerrain& Terrain, int InGoalIndex, HexSearchContext& Context);
+
+    // Index into AHexGridManager::DirectionVectors, NoDirection at the goal or when it can't be reached
+    uint8 GetDirection(const int Index) const { return Directions[Index]; }
+
+    // Cost of the remaining path
+    float GetCost(const int Index) const { return Costs[Index]; }
+
+    // Next hex on the way to the goal, returns false at the goal or when it can't be reached
+    bool GetNextHex(const Hex& From, Hex& OutNext) const;
+
+    int GetGoalIndex() const { return GoalIndex; }
+
+    // Set when a tile changed after the field was built
+    bool Dirty = true;
+
+    // Last use, for evicting the oldest cached field
+    uint32 LastUsed = 0;
+
+private:
+    HexGridLayout Layout;
+    int GoalIndex = INDEX_NONE;
+
+    std::vector<uint8> Directions;
+    std::vector<float> Costs;
+};
@@ -3,10 +3,30 @@
 
 #include "HexGridManager.h"
 
+#include <algorithm>
+
 #include "Hex.h"
 #include "LineTypes.h"
 #include "UOCTestGameMode.h"
+#include "Async/ParallelFor.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "Net/UnrealNetwork.h"
+#include "Tasks/Task.h"
+
+namespace
+{
+    // Landmarks only cover the current grid
+    HexSearchSettings WithoutLandmarks(const HexSearchSettings& Settings)
+    {
+        HexSearchSettings Result = Settings;
+        if (Result.Heuristic == EHexHeuristic::Landmarks)
+        {
+            Result.Heuristic = EHexHeuristic::HexDistance;
+        }
+        return Result;
+    }
+}
 
 // Sets default values
 AHexGridManager::AHexGridManager()
@@ -14,6 +34,18 @@ AHexGridManager::AHexGridManager()
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
+    // Every client needs the whole grid
+    bReplicates = true;
+    bAlwaysRelevant = true;
+    TerrainChunks.Owner = this;
+}
+
+void AHexGridManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME(AHexGridManager, ReplicatedLayout);
+    DOREPLIFETIME(AHexGridManager, TerrainChunks);
 }
 
 // Called when the game starts or when spawned
@@ -21,8 +53,11 @@ void AHexGridManager::BeginPlay()
 {
 	Super::BeginPlay();
 
-	AUOCTestGameMode* GameMode = Cast<AUOCTestGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
-	GameMode->GridManager = this;
+	// Only the server has a game mode, clients find the manager through APlayerCamera::GetGridManager
+	if (AUOCTestGameMode* GameMode = Cast<AUOCTestGameMode>(UGameplayStatics::GetGameMode(GetWorld())))
+	{
+		GameMode->GridManager = this;
+	}
 
     // Populate materials map
     Materials = decltype(Materials)
@@ -43,69 +78,741 @@ void AHexGridManager::BeginPlay()
 
 	VerticalTileSpacing = TileHeight / 2.f;
 
+    InitTerrainGenerator();
+    EditJournal.Init(MaxUndoSteps);
+    PathService.Init(&Terrain, &Regions);
+    FlowFields.assign(FMath::Max(MaxFlowFields, 1), HexFlowField());
+
+    // The grid is the window of chunks around the camera, Tick moves it along
+    if (StreamChunks)
+    {
+        const int WindowChunks = (StreamRadius * 2 + 1) * (StreamRadius * 2 + 1);
+        ChunkStore.Init(ChunkSize, FMath::Max(MaxCachedChunks, WindowChunks), ProceduralTerrain ? HexChunkStore::ChunkGenerator(
+            [this](const HexGridLayout& ChunkLayout, EHexTypes* OutTypes) { TerrainGenerator.Generate(ChunkLayout, OutTypes); }) : nullptr);
+        StreamAround(Hex());
+
+        // Chunks register themselves, the first Tick only announces the grid
+        BuildStage = EHexGridBuildStage::Registering;
+        return;
+    }
+
+    // Clients build the grid of the server once its layout arrives. A layout that came with the
+    // initial replication, before BeginPlay, was only recorded by OnRep_GridLayout.
+    if (!HasAuthority())
+    {
+        if (ReplicatedLayout.Width > 0 && ReplicatedLayout.Height > 0)
+        {
+            StartGridBuild(ReplicatedLayout.ToLayout(), nullptr, true);
+        }
+        return;
+    }
+
+    TSharedPtr<HexMapFile, ESPMode::ThreadSafe> Map;
+    if (!MapPath.IsEmpty())
+    {
+        Map = MakeShared<HexMapFile, ESPMode::ThreadSafe>();
+        if (!Map->Open(ResolveMapPath(MapPath)))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Hex map %s can't be opened, generating the grid"), *MapPath);
+            Map.Reset();
+        }
+    }
+
 	// generate grid
-	GenerateGrid();
+	StartGridBuild(Map ? Map->GetLayout() : HexGridLayout(LeftCount, RightCount, UpCount, DownCount), Map, false);
 }
 
-void AHexGridManager::Tick(float DeltaTime)
+void AHexGridManager::StartGridBuild(const HexGridLayout& Layout, TSharedPtr<HexMapFile, ESPMode::ThreadSafe> Map, const bool Replica)
 {
-	Super::Tick(DeltaTime);
+    UE_LOG(LogTemp, Verbose, TEXT("Hex grid: tile %f x %f, spacing %f x %f, outer %f, inner %f"),
+        TileWidth, TileHeight, HorizontalTileSpacing, VerticalTileSpacing, OuterTileSize, InnerTileSize);
 
-	// UE::Geometry::FLine3d line = UE::Geometry::FLine3d();
-	
+    InitGrid(Layout);
+
+    BuildStage = EHexGridBuildStage::Preparing;
+    BuildCursor = 0;
+    EditJournal.Clear();
+    PathService.SetPaused(true);
+
+    // The worker only gets copies, the actor may be gone before it finishes
+    BuildData = MakeShared<GridBuildData, ESPMode::ThreadSafe>();
+    UE::Tasks::Launch(TEXT("HexGridBuild"), [Data = BuildData, Layout, Horizontal = HorizontalTileSpacing, Vertical = VerticalTileSpacing,
+        Rotation = FRotator(0.f, IsFlatTopLayout ? 30.f : 0.f, 0.f), Generator = TerrainGenerator, Procedural = ProceduralTerrain, Map, Replica]()
+    {
+        Data->Transforms.resize(Layout.Num());
+        Data->Types.assign(Layout.Num(), Replica ? EHexTypes::Invalid : EHexTypes::Grass);
+
+        if (Map)
+        {
+            const double MapStart = FPlatformTime::Seconds();
+            Data->FromMap = true;
+            Data->MapDamaged = !Map->ReadTypes(Data->Types.data());
+            Data->MapMapped = Map->IsMapped();
+            Data->MapSeconds = FPlatformTime::Seconds() - MapStart;
+            Data->MapBytes = Map->GetFileBytes();
+        }
+
+        if (!Replica && (Data->MapDamaged || (!Map && Procedural)))
+        {
+            Generator.Generate(Layout, Data->Types.data());
+        }
+
+        // Every column is a contiguous run of indices
+        ParallelFor(Layout.Width, [&Data, &Layout, Horizontal, Vertical, &Rotation](const int32 Column)
+        {
+            for (int Index = Column * Layout.Height; Index < (Column + 1) * Layout.Height; Index++)
+            {
+                const Hex Tile = Layout.HexAt(Index);
+                const Point Location = HexToWorldPoint(Tile, Horizontal, Vertical);
+                Data->Transforms[Index] = FTransform(Rotation, FVector(Location.X, Location.Y, 0.f));
+            }
+        });
+
+        Data->Done.store(true, std::memory_order_release);
+    });
 }
 
-void AHexGridManager::GenerateGrid()
+void AHexGridManager::UpdateGridBuild()
 {
-	UE_LOG(LogTemp, Warning, TEXT("HorizontalTileSpacing %f"), HorizontalTileSpacing);
-	UE_LOG(LogTemp, Warning, TEXT("VerticalTileSpacing %f"), VerticalTileSpacing);
-	UE_LOG(LogTemp, Warning, TEXT("TileWidth %f"), TileWidth);
-	UE_LOG(LogTemp, Warning, TEXT("TileHeight %f"), TileHeight);
-	UE_LOG(LogTemp, Warning, TEXT("OuterTileSize %f"), OuterTileSize);
-	UE_LOG(LogTemp, Warning, TEXT("InnerTileSize %f"), InnerTileSize);
+    if (BuildStage == EHexGridBuildStage::Preparing && BuildData->Done.load(std::memory_order_acquire))
+    {
+        FinishTerrainStage();
+    }
 
-    // Generate grid and add the HexTileMap
-	for (int q = LeftCount; q <= RightCount; q++)
-	{
-		const int QOffset = floor(q/2.f);
-		for (int r = UpCount - QOffset; r <= DownCount - QOffset; r++)
-		{
-		    // Create hex
-			Hex hex = Hex(q, r, -q-r);
+    if (BuildStage != EHexGridBuildStage::Registering)
+    {
+        return;
+    }
 
-		    // Get world location and rotation
-			Point SpawnLocation = HexToWorldPoint(hex);
-			float YawRotation = IsFlatTopLayout ? 30.f : 0.f;
+    const double Deadline = FPlatformTime::Seconds() + GridBuildBudgetMs * 1e-3;
+    if (StreamChunks || RegisterTiles(Deadline))
+    {
+        BuildStage = EHexGridBuildStage::Ready;
+        BuildData.Reset();
+        OnGridBuildProgress.Broadcast(1.f);
+        OnGridReady.Broadcast();
+        return;
+    }
 
-		    // Instantiate blueprint on location
-		    AHexTile* Tile = GetWorld()->SpawnActor<AHexTile>(HexTile, FVector(SpawnLocation.X, SpawnLocation.Y, 0.f), FRotator(0.f, YawRotation, 0.f));
-			Tile->SetActorLabel(FString::Printf(TEXT("Tile_%d_%d_%d"), q, r, -q-r));
-		    Tile->Init(Materials[EHexTypes::Grass]);
+    OnGridBuildProgress.Broadcast(static_cast<float>(BuildCursor) / FMath::Max(Terrain.Num(), 1));
+}
 
-		    // Save to map for future use
-			HexTileMap[hex] = Tile;
-		}
-	}
+void AHexGridManager::FinishTerrainStage()
+{
+    if (BuildData->MapDamaged)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Hex map is damaged, generated the grid instead"));
+    }
+    else if (BuildData->FromMap)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Hex map loaded: %d tiles in %.2f ms, %.3f bytes per tile, %s"), Terrain.Num(), BuildData->MapSeconds * 1000.0,
+            static_cast<double>(BuildData->MapBytes) / FMath::Max(Terrain.Num(), 1), BuildData->MapMapped ? TEXT("mapped") : TEXT("read"));
+    }
+
+    // Chunks that arrived during the build, later ones come through OnTerrainChunkReplicated
+    if (!HasAuthority())
+    {
+        const int TileCount = Terrain.Num();
+        for (const FHexTerrainChunk& Item : TerrainChunks.Items)
+        {
+            const int First = Item.Chunk * FHexTerrainChunkArray::ChunkTiles;
+            if (Item.Chunk < 0 || First >= TileCount)
+            {
+                continue;
+            }
+
+            // A damaged chunk keeps the types the build already has, Decode may have written part of it
+            const int Count = FMath::Min(FHexTerrainChunkArray::ChunkTiles, TileCount - First);
+            ReplicatedChunkTypes.resize(Count);
+            if (FHexTerrainChunkArray::Decode(Item.Runs, ReplicatedChunkTypes.data(), Count))
+            {
+                std::copy(ReplicatedChunkTypes.begin(), ReplicatedChunkTypes.end(), BuildData->Types.begin() + First);
+            }
+        }
+        ReplicatedEdits.clear();
+    }
+
+    for (int Index = 0; Index < Terrain.Num(); Index++)
+    {
+        const EHexTypes Type = BuildData->Types[Index];
+        Terrain.SetTile(Index, Type, GetTypeCost(Type));
+    }
+
+    BuildTerrainGraphs();
+    InvalidateTerrainCaches();
+    BuildStage = EHexGridBuildStage::Registering;
+
+    // Edits made meanwhile win over the generated types, they aren't undo steps
+    std::vector<HexTileEdit> Edits;
+    for (const std::pair<Hex, EHexTypes>& Edit : PendingEdits)
+    {
+        Edits.push_back(HexTileEdit { HexKey(Edit.first), GetHexType(Edit.first), Edit.second });
+    }
+    ApplyTileEdits(Edits, false);
+    PendingEdits.clear();
+
+    if (ReplicatesTerrain())
+    {
+        ReplicateAllChunks();
+    }
+
+    PathService.SetPaused(false);
+}
+
+bool AHexGridManager::RegisterTiles(const double Deadline)
+{
+    const HexGridLayout& Layout = Terrain.GetLayout();
+    const std::vector<FTransform>& Transforms = BuildData->Transforms;
+
+    // Look at the clock once per batch
+    const int BatchSize = RenderMode == EHexRenderMode::Instanced ? 1024 : 16;
+
+    while (BuildCursor < Layout.Num() && FPlatformTime::Seconds() < Deadline)
+    {
+        const int BatchEnd = FMath::Min(BuildCursor + BatchSize, Layout.Num());
+
+        if (RenderMode == EHexRenderMode::Instanced)
+        {
+            if (!TileInstances)
+            {
+                TileInstances = CreateInstanceComponent(TEXT("TileInstances"));
+            }
+
+            // Added in layout order, so the instance index is the tile index
+            TArray<FTransform> Batch(&Transforms[BuildCursor], BatchEnd - BuildCursor);
+            TileInstances->AddInstances(Batch, false, true);
+            for (int Index = BuildCursor; Index < BatchEnd; Index++)
+            {
+                TileInstances->SetCustomDataValue(Index, InstanceDataType, static_cast<float>(Terrain.GetType(Index)), false);
+                TileInstances->SetCustomDataValue(Index, InstanceDataSelected, TileSelected[Index] ? 1.f : 0.f, false);
+            }
+            TileInstancesDirty = true;
+        }
+        else
+        {
+            for (int Index = BuildCursor; Index < BatchEnd; Index++)
+            {
+                // Instantiate blueprint on location
+                const Hex H = Layout.HexAt(Index);
+                AHexTile* Tile = GetWorld()->SpawnActor<AHexTile>(HexTile, Transforms[Index]);
+                Tile->SetActorLabel(FString::Printf(TEXT("Tile_%d_%d_%d"), H.Q, H.R, H.S));
+                Tile->SetActorEnableCollision(TileCollision);
+
+                // Mirror the terrain type, selections made during the build included
+                const EHexTypes Type = Terrain.GetType(Index);
+                Tile->SetType(Type, GetMaterial(Type));
+                if (TileSelected[Index])
+                {
+                    Tile->Select(SelectedMaterial);
+                }
+
+                HexTiles[Index] = Tile;
+                RenderUpdateCount++;
+            }
+        }
+
+        BuildCursor = BatchEnd;
+    }
+
+    return BuildCursor == Layout.Num();
+}
+
+FString AHexGridManager::ResolveMapPath(const FString& Path) const
+{
+    return FPaths::IsRelative(Path) ? FPaths::Combine(FPaths::ProjectSavedDir(), Path) : Path;
+}
+
+bool AHexGridManager::SaveMap(const FString& Path)
+{
+    if (StreamChunks || !IsTerrainReady())
+    {
+        return false;
+    }
+
+    const double SaveStart = FPlatformTime::Seconds();
+    int64 FileBytes = 0;
+    if (!HexMapFile::Save(ResolveMapPath(Path), Terrain, MapCompression, &FileBytes))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Hex map %s can't be written"), *Path);
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Hex map saved: %d tiles in %.2f ms, %.3f bytes per tile"), Terrain.Num(),
+        (FPlatformTime::Seconds() - SaveStart) * 1000.0, static_cast<double>(FileBytes) / FMath::Max(Terrain.Num(), 1));
+    return true;
+}
+
+bool AHexGridManager::LoadMap(const FString& Path)
+{
+    if (StreamChunks || !IsGridReady())
+    {
+        return false;
+    }
+
+    TSharedPtr<HexMapFile, ESPMode::ThreadSafe> Map = MakeShared<HexMapFile, ESPMode::ThreadSafe>();
+    if (!Map->Open(ResolveMapPath(Path)))
+    {
+        return false;
+    }
+
+    ClearTileVisuals();
+    StartGridBuild(Map->GetLayout(), Map, false);
+    return true;
+}
+
+void AHexGridManager::ClearTileVisuals()
+{
+    // The new grid registers every tile again
+    for (int Index = 0; Index < HexTiles.Num(); Index++)
+    {
+        if (AHexTile* Tile = HexTiles[Index])
+        {
+            Tile->Destroy();
+            HexTiles[Index] = nullptr;
+        }
+    }
+
+    if (TileInstances)
+    {
+        TileInstances->ClearInstances();
+    }
+}
+
+void AHexGridManager::OnRep_GridLayout()
+{
+    // Spacings, generator and journal aren't set up yet, BeginPlay starts the build
+    if (!HasActorBegunPlay())
+    {
+        return;
+    }
+
+    const HexGridLayout Layout = ReplicatedLayout.ToLayout();
+    if (BuildStage != EHexGridBuildStage::NotStarted && Layout == Terrain.GetLayout())
+    {
+        return;
+    }
+
+    ClearTileVisuals();
+    StartGridBuild(Layout, nullptr, true);
+}
+
+void AHexGridManager::OnTerrainChunkReplicated(const FHexTerrainChunk& Item)
+{
+    // Chunks of a grid still being built are read by FinishTerrainStage
+    const int TileCount = Terrain.Num();
+    const int First = Item.Chunk * FHexTerrainChunkArray::ChunkTiles;
+    if (HasAuthority() || !IsTerrainReady() || Item.Chunk < 0 || First >= TileCount)
+    {
+        return;
+    }
+
+    const int Count = FMath::Min(FHexTerrainChunkArray::ChunkTiles, TileCount - First);
+    ReplicatedChunkTypes.resize(Count);
+    if (!FHexTerrainChunkArray::Decode(Item.Runs, ReplicatedChunkTypes.data(), Count))
+    {
+        return;
+    }
+
+    const HexGridLayout& Layout = Terrain.GetLayout();
+    for (int Local = 0; Local < Count; Local++)
+    {
+        const EHexTypes Old = Terrain.GetType(First + Local);
+        if (Old != ReplicatedChunkTypes[Local])
+        {
+            ReplicatedEdits.push_back(HexTileEdit { HexKey(Layout.HexAt(First + Local)), Old, ReplicatedChunkTypes[Local] });
+        }
+    }
+}
+
+void AHexGridManager::ReplicateAllChunks()
+{
+    ReplicatedLayout.FromLayout(Terrain.GetLayout());
+
+    // Every chunk changes on a new grid, resend the array as a whole
+    const int ChunkCount = FHexTerrainChunkArray::ChunkCount(Terrain.GetLayout());
+    TerrainChunks.Items.SetNum(ChunkCount);
+
+    std::vector<EHexTypes> Types(FHexTerrainChunkArray::ChunkTiles);
+    for (int Chunk = 0; Chunk < ChunkCount; Chunk++)
+    {
+        const int First = Chunk * FHexTerrainChunkArray::ChunkTiles;
+        const int Count = FMath::Min(FHexTerrainChunkArray::ChunkTiles, Terrain.Num() - First);
+        for (int Local = 0; Local < Count; Local++)
+        {
+            Types[Local] = Terrain.GetType(First + Local);
+        }
+
+        FHexTerrainChunk& Item = TerrainChunks.Items[Chunk];
+        Item.Chunk = Chunk;
+        FHexTerrainChunkArray::Encode(Types.data(), Count, Item.Runs);
+        TerrainChunks.MarkItemDirty(Item);
+    }
+    TerrainChunks.MarkArrayDirty();
+
+    UE_LOG(LogTemp, Log, TEXT("Hex terrain snapshot: %d tiles in %d chunks, %lld bytes, %.3f bytes per tile"), Terrain.Num(), ChunkCount,
+        TerrainChunks.GetEncodedBytes(), static_cast<double>(TerrainChunks.GetEncodedBytes()) / FMath::Max(Terrain.Num(), 1));
+
+    if (TerrainChunks.GetEncodedBytes() > GetJoinSnapshotTargetBytes())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Hex terrain snapshot is %lld bytes, over the join target of %lld bytes"),
+            TerrainChunks.GetEncodedBytes(), GetJoinSnapshotTargetBytes());
+    }
+}
+
+void AHexGridManager::ReplicateChunks(const std::vector<HexTileEdit>& Edits)
+{
+    // A snapshot of another layout is still pending
+    if (TerrainChunks.Items.Num() != FHexTerrainChunkArray::ChunkCount(Terrain.GetLayout()))
+    {
+        return;
+    }
+
+    std::vector<int> Chunks;
+    for (const HexTileEdit& Edit : Edits)
+    {
+        const int Index = Terrain.GetLayout().IndexOf(Edit.Tile.ToHex());
+        if (Index != INDEX_NONE)
+        {
+            Chunks.push_back(Index / FHexTerrainChunkArray::ChunkTiles);
+        }
+    }
+
+    std::sort(Chunks.begin(), Chunks.end());
+    Chunks.erase(std::unique(Chunks.begin(), Chunks.end()), Chunks.end());
+
+    int64 Bytes = 0;
+    std::vector<EHexTypes> Types(FHexTerrainChunkArray::ChunkTiles);
+    for (const int Chunk : Chunks)
+    {
+        const int First = Chunk * FHexTerrainChunkArray::ChunkTiles;
+        const int Count = FMath::Min(FHexTerrainChunkArray::ChunkTiles, Terrain.Num() - First);
+        for (int Local = 0; Local < Count; Local++)
+        {
+            Types[Local] = Terrain.GetType(First + Local);
+        }
+
+        FHexTerrainChunk& Item = TerrainChunks.Items[Chunk];
+        FHexTerrainChunkArray::Encode(Types.data(), Count, Item.Runs);
+        TerrainChunks.MarkItemDirty(Item);
+        Bytes += Item.Runs.Num();
+    }
+
+    UE_LOG(LogTemp, Verbose, TEXT("Hex terrain delta: %d edits in %d chunks, %lld bytes, %.1f bytes per edit"), static_cast<int>(Edits.size()),
+        static_cast<int>(Chunks.size()), Bytes, static_cast<double>(Bytes) / FMath::Max(static_cast<int>(Edits.size()), 1));
+}
+
+void AHexGridManager::InitTerrainGenerator()
+{
+    HexTerrainGeneratorSettings Settings;
+    Settings.Seed = TerrainSeed;
+    Settings.FeatureSize = TerrainFeatureSize;
+    Settings.Octaves = TerrainOctaves;
+    Settings.WaterLevel = WaterLevel;
+    Settings.DirtLevel = DirtLevel;
+    Settings.BlockedLevel = BlockedLevel;
+    TerrainGenerator.Init(Settings, HorizontalTileSpacing, VerticalTileSpacing);
+}
+
+bool AHexGridManager::RegenerateTerrain(const int32 Seed)
+{
+    if (!IsTerrainReady())
+    {
+        return false;
+    }
+
+    TerrainSeed = Seed;
+    InitTerrainGenerator();
+    EditJournal.Clear();
+
+    // Drop every chunk and its edits, the window reloads around the same center
+    if (StreamChunks)
+    {
+        ChunkStore.Init(ChunkSize, ChunkStore.GetMaxResidentChunks(),
+            [this](const HexGridLayout& ChunkLayout, EHexTypes* OutTypes) { TerrainGenerator.Generate(ChunkLayout, OutTypes); });
+        for (int Slot = 0; Slot < ChunkInstances.Num(); Slot++)
+        {
+            ChunkInstances[Slot]->ClearInstances();
+            ChunkInstanceUsed[Slot] = 0;
+            ChunkInstanceDirty[Slot] = 0;
+        }
+
+        StreamWindowValid = false;
+        StreamAround(ChunkStore.GetChunkLayout(StreamCenter).HexAt(0));
+        return true;
+    }
+
+    std::vector<EHexTypes> Types(Terrain.Num());
+    TerrainGenerator.Generate(Terrain.GetLayout(), Types.data());
+
+    for (int Index = 0; Index < Terrain.Num(); Index++)
+    {
+        Terrain.SetTile(Index, Types[Index], GetTypeCost(Types[Index]));
+    }
+
+    BuildTerrainGraphs();
+    InvalidateTerrainCaches();
+
+    // Tiles not registered yet read their type from the terrain when they are
+    for (int Index = 0; Index < Terrain.Num(); Index++)
+    {
+        if (AHexTile* Tile = HexTiles[Index])
+        {
+            Tile->SetType(Types[Index], GetMaterial(Types[Index]));
+            if (TileSelected[Index])
+            {
+                Tile->Select(SelectedMaterial);
+            }
+        }
+        else if (TileInstances && Index < TileInstances->GetInstanceCount())
+        {
+            SetInstanceData(Index, InstanceDataType, static_cast<float>(Types[Index]));
+        }
+    }
+    RenderUpdateCount += Terrain.Num();
+
+    if (ReplicatesTerrain())
+    {
+        ReplicateAllChunks();
+    }
+
+    return true;
 }
 
-std::vector<Hex> AHexGridManager::GetNeighbors(const Hex& H)
+void AHexGridManager::InitGrid(const HexGridLayout& Layout)
 {
-    std::vector<Hex> Neighbors;
-    for (auto Direction : DirectionVectors)
+    HexTiles.Init(Layout, nullptr);
+    Terrain.Init(Layout, EHexTypes::Grass, GetTypeCost(EHexTypes::Grass), GetMinTileCost());
+    if (StreamChunks)
     {
-        Hex TmpHex = Add(H, Direction);
-        if (HexTileMap.count(TmpHex) > 0)
+        FillTerrainFromChunks(Terrain);
+    }
+
+    TileSelected.assign(Layout.Num(), 0);
+    SelectionMark.assign(Layout.Num(), 0);
+    SelectedTiles.clear();
+}
+
+void AHexGridManager::BuildTerrainGraphs()
+{
+    IncrementalPlanner.Init(&Terrain, GetMinTileCost());
+    ClusterGraph.Build(&Terrain, ClusterSize, GetMinTileCost());
+    Regions.Build(&Terrain);
+}
+
+void AHexGridManager::InvalidateTerrainCaches()
+{
+    Landmarks.Dirty = true;
+    PathService.OnTerrainChanged();
+    TerrainVersion++;
+
+    // Sliced searches read the live terrain, anything they expanded so far may be wrong now
+    for (SlicedPathRequest& Request : SlicedPaths)
+    {
+        if (Request.Search->IsRunning())
         {
-            Neighbors.push_back(TmpHex);
+            Request.Search->Restart();
         }
     }
 
-    return Neighbors;
+    for (HexFlowField& Field : FlowFields)
+    {
+        Field.Dirty = true;
+    }
+}
+
+void AHexGridManager::StreamAround(const Hex& Focus)
+{
+    const HexKey Center = ChunkStore.ChunkOf(Focus);
+    if (StreamWindowValid && Center == StreamCenter)
+    {
+        return;
+    }
+
+    StreamCenter = Center;
+    StreamWindowValid = true;
+
+    // Tile indices of the old window mean nothing in the new one
+    UnselectHexes();
+
+    const HexKey MinChunk(Center.GetQ() - StreamRadius, Center.GetR() - StreamRadius);
+    const HexKey MaxChunk(Center.GetQ() + StreamRadius, Center.GetR() + StreamRadius);
+    InitGrid(ChunkStore.GetChunkLayout(MinChunk, MaxChunk));
+    BuildTerrainGraphs();
+    InvalidateTerrainCaches();
+    UpdateChunkInstances(MinChunk, MaxChunk);
+}
+
+void AHexGridManager::UpdateChunkInstances(const HexKey MinChunk, const HexKey MaxChunk)
+{
+    auto InWindow = [MinChunk, MaxChunk](const HexKey Chunk)
+    {
+        return Chunk.GetQ() >= MinChunk.GetQ() && Chunk.GetQ() <= MaxChunk.GetQ()
+            && Chunk.GetR() >= MinChunk.GetR() && Chunk.GetR() <= MaxChunk.GetR();
+    };
+
+    // Components of chunks that left the window go back to the pool
+    for (int Slot = 0; Slot < ChunkInstances.Num(); Slot++)
+    {
+        if (ChunkInstanceUsed[Slot] && !InWindow(ChunkInstanceKeys[Slot]))
+        {
+            ChunkInstances[Slot]->ClearInstances();
+            ChunkInstanceUsed[Slot] = 0;
+            ChunkInstanceDirty[Slot] = 0;
+        }
+    }
+
+    // Chunks that entered it take a pooled component, chunks that stayed keep theirs
+    for (int X = MinChunk.GetQ(); X <= MaxChunk.GetQ(); X++)
+    {
+        for (int Y = MinChunk.GetR(); Y <= MaxChunk.GetR(); Y++)
+        {
+            const HexKey Chunk(X, Y);
+            if (FindChunkInstances(Chunk) != INDEX_NONE)
+            {
+                continue;
+            }
+
+            int Slot = 0;
+            while (Slot < ChunkInstances.Num() && ChunkInstanceUsed[Slot])
+            {
+                Slot++;
+            }
+
+            if (Slot == ChunkInstances.Num())
+            {
+                ChunkInstances.Add(CreateInstanceComponent(NAME_None));
+                ChunkInstanceKeys.push_back(Chunk);
+                ChunkInstanceUsed.push_back(0);
+                ChunkInstanceDirty.push_back(0);
+            }
+
+            ChunkInstanceKeys[Slot] = Chunk;
+            ChunkInstanceUsed[Slot] = 1;
+            FillInstances(ChunkInstances[Slot], ChunkStore.GetChunkLayout(Chunk));
+        }
+    }
+}
+
+int AHexGridManager::FindChunkInstances(const HexKey Chunk) const
+{
+    for (int Slot = 0; Slot < ChunkInstances.Num(); Slot++)
+    {
+        if (ChunkInstanceUsed[Slot] && ChunkInstanceKeys[Slot] == Chunk)
+        {
+            return Slot;
+        }
+    }
+
+    return INDEX_NONE;
+}
+
+void AHexGridManager::FillTerrainFromChunks(HexTerrain& Target)
+{
+    // Target layouts are always whole chunks
+    const HexGridLayout& Layout = Target.GetLayout();
+    const int Size = ChunkStore.GetChunkSize();
+    for (int X = Layout.Left / Size; X < (Layout.Left + Layout.Width) / Size; X++)
+    {
+        for (int Y = Layout.Up / Size; Y < (Layout.Up + Layout.Height) / Size; Y++)
+        {
+            const HexKey Chunk(X, Y);
+            const EHexTypes* Types = ChunkStore.Acquire(Chunk);
+            const HexGridLayout ChunkLayout = ChunkStore.GetChunkLayout(Chunk);
+            for (int Local = 0; Local < ChunkLayout.Num(); Local++)
+            {
+                Target.SetTile(Layout.IndexOf(ChunkLayout.HexAt(Local)), Types[Local], GetTypeCost(Types[Local]));
+            }
+        }
+    }
+}
+
+const HexTerrain* AHexGridManager::LoadPathWindow(const Hex& Start, const Hex& End)
+{
+    // One chunk of margin lets paths bend around obstacles at the edge of the bounding box
+    const HexKey A = ChunkStore.ChunkOf(Start);
+    const HexKey B = ChunkStore.ChunkOf(End);
+    const HexKey MinChunk(FMath::Min(A.GetQ(), B.GetQ()) - 1, FMath::Min(A.GetR(), B.GetR()) - 1);
+    const HexKey MaxChunk(FMath::Max(A.GetQ(), B.GetQ()) + 1, FMath::Max(A.GetR(), B.GetR()) + 1);
+
+    const int64 ChunkCount = static_cast<int64>(MaxChunk.GetQ() - MinChunk.GetQ() + 1) * (MaxChunk.GetR() - MinChunk.GetR() + 1);
+    if (ChunkCount > MaxPathChunks)
+    {
+        return nullptr;
+    }
+
+    const HexGridLayout Layout = ChunkStore.GetChunkLayout(MinChunk, MaxChunk);
+    if (!PathWindowValid || PathWindowVersion != TerrainVersion || PathWindowTerrain.GetLayout() != Layout)
+    {
+        PathWindowTerrain.Init(Layout, EHexTypes::Grass, GetTypeCost(EHexTypes::Grass), GetMinTileCost());
+        FillTerrainFromChunks(PathWindowTerrain);
+        PathWindowVersion = TerrainVersion;
+        PathWindowValid = true;
+    }
+
+    return &PathWindowTerrain;
+}
+
+void AHexGridManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// UE::Geometry::FLine3d line = UE::Geometry::FLine3d();
+
+    UpdateGridBuild();
+
+    // Every replicated chunk of the last frame as one batch
+    if (!ReplicatedEdits.empty())
+    {
+        ApplyTileEdits(ReplicatedEdits, false);
+        ReplicatedEdits.clear();
+    }
+
+    // Hand finished async paths back to their callers
+    PathService.DeliverResults();
+
+    UpdateSlicedPaths();
+
+    if (StreamChunks)
+    {
+        if (const APawn* Focus = UGameplayStatics::GetPlayerPawn(GetWorld(), 0))
+        {
+            StreamAround(WorldToHex(Focus->GetActorLocation()));
+        }
+    }
+
+    if (TileInstancesDirty)
+    {
+        if (TileInstances)
+        {
+            TileInstances->MarkRenderStateDirty();
+            RenderUpdateCount++;
+        }
+
+        for (int Slot = 0; Slot < ChunkInstances.Num(); Slot++)
+        {
+            if (ChunkInstanceDirty[Slot])
+            {
+                ChunkInstances[Slot]->MarkRenderStateDirty();
+                ChunkInstanceDirty[Slot] = 0;
+                RenderUpdateCount++;
+            }
+        }
+        TileInstancesDirty = false;
+    }
+
+    RenderUpdatesLastFrame = RenderUpdateCount;
+    RenderUpdateCount = 0;
+}
+
+HexNeighbors AHexGridManager::GetNeighbors(const Hex& H) const
+{
+    const int Index = Terrain.GetLayout().IndexOf(H);
+    return Index != INDEX_NONE ? HexNeighbors(Terrain.GetLayout(), Index) : HexNeighbors();
 }
 
 Hex AHexGridManager::GetHexDirection(const Hex& From, const Hex& To)
 {
-    return Subtract(To, From);
+    return Hex::Subtract(To, From);
 }
 
 FVector AHexGridManager::GetVectorDirection(const Hex& From, const Hex& To)
@@ -113,32 +820,100 @@ FVector AHexGridManager::GetVectorDirection(const Hex& From, const Hex& To)
     return FVector(To.Q - From.Q, To.R - From.R, To.S - From.S);
 }
 
-UMaterialInstance* AHexGridManager::GetMaterial(EHexTypes Type)
+UHierarchicalInstancedStaticMeshComponent* AHexGridManager::CreateInstanceComponent(const FName Name)
 {
-    if (Materials.count(Type))
+    UHierarchicalInstancedStaticMeshComponent* Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, Name);
+    if (RootComponent)
     {
-        return Materials[Type];
+        Component->SetupAttachment(RootComponent);
     }
     else
     {
-        return Materials[EHexTypes::Invalid];
+        SetRootComponent(Component);
+    }
+
+    UStaticMesh* Mesh = InstancedTileMesh ? InstancedTileMesh : LoadObject<UStaticMesh>(nullptr, TEXT("/Game/Binx/Art/HexMesh"));
+    Component->SetStaticMesh(Mesh);
+    if (InstancedTileMaterial)
+    {
+        Component->SetMaterial(0, InstancedTileMaterial);
     }
+    Component->NumCustomDataFloats = InstanceDataCount;
+    Component->SetCollisionEnabled(TileCollision ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+    Component->RegisterComponent();
+    return Component;
 }
 
-AHexTile* AHexGridManager::GetTileByHex(Hex& H)
+void AHexGridManager::FillInstances(UHierarchicalInstancedStaticMeshComponent* Component, const HexGridLayout& Layout)
 {
-	if (HexTileMap.count(H))
-	{
-		return HexTileMap[H];
-	}
+    // Added in layout order, so the instance index is the index in Layout
+    const FRotator Rotation(0.f, IsFlatTopLayout ? 30.f : 0.f, 0.f);
+    TArray<FTransform> Transforms;
+    Transforms.Reserve(Layout.Num());
+    for (int Index = 0; Index < Layout.Num(); Index++)
+    {
+        const Point Location = HexToWorldPoint(Layout.HexAt(Index));
+        Transforms.Add(FTransform(Rotation, FVector(Location.X, Location.Y, 0.f)));
+    }
+    Component->ClearInstances();
+    Component->AddInstances(Transforms, false, true);
+
+    for (int Index = 0; Index < Layout.Num(); Index++)
+    {
+        const EHexTypes Type = GetHexType(Layout.HexAt(Index));
+        Component->SetCustomDataValue(Index, InstanceDataType, static_cast<float>(Type), false);
+    }
+    Component->MarkRenderStateDirty();
+    RenderUpdateCount++;
+}
+
+void AHexGridManager::SetInstanceData(const int Index, const int DataIndex, const float Value)
+{
+    TileInstancesDirty = true;
+
+    if (TileInstances)
+    {
+        TileInstances->SetCustomDataValue(Index, DataIndex, Value, false);
+        return;
+    }
+
+    // Streamed tiles live in the component of their chunk
+    const Hex H = Terrain.GetLayout().HexAt(Index);
+    const HexKey Chunk = ChunkStore.ChunkOf(H);
+    const int Slot = FindChunkInstances(Chunk);
+    if (Slot != INDEX_NONE)
+    {
+        ChunkInstances[Slot]->SetCustomDataValue(ChunkStore.GetChunkLayout(Chunk).IndexOf(H), DataIndex, Value, false);
+        ChunkInstanceDirty[Slot] = 1;
+    }
+}
 
-	return nullptr;
+UMaterialInstance* AHexGridManager::GetMaterial(EHexTypes Type)
+{
+    const auto It = Materials.find(Type);
+    if (It != Materials.end())
+    {
+        return It->second;
+    }
+
+    return Materials[EHexTypes::Invalid];
+}
+
+AHexTile* AHexGridManager::GetTileByHex(const Hex& H)
+{
+	AHexTile** Tile = HexTiles.Find(H);
+	return Tile ? *Tile : nullptr;
 }
 
 Point AHexGridManager::HexToWorldPoint(const Hex Tile) const
 {
-	const float Right = Tile.Q * HorizontalTileSpacing; // 150
-	const float Up = VerticalTileSpacing * Tile.Q + Tile.R * VerticalTileSpacing * 2.f; // 86.6
+    return HexToWorldPoint(Tile, HorizontalTileSpacing, VerticalTileSpacing);
+}
+
+Point AHexGridManager::HexToWorldPoint(const Hex Tile, const float HorizontalSpacing, const float VerticalSpacing)
+{
+	const float Right = Tile.Q * HorizontalSpacing; // 150
+	const float Up = VerticalSpacing * Tile.Q + Tile.R * VerticalSpacing * 2.f; // 86.6
 
 	// His way
 	// Right = OuterTileSize * (3./2 * Tile.Q);
@@ -169,7 +944,12 @@ Hex AHexGridManager::WorldToHex(const FVector& Location) const
 	// // Up = -OuterTileSize * (sqrt(3)/2 * Tile.Q + sqrt(3) * Tile.R);
 	//
 	// return Point(Up, Right);
-	return HexRound(LocationToFractionalHex(Location));
+	return Hex::Round(LocationToFractionalHex(Location));
+}
+
+void AHexGridManager::WorldToHexes(const double* X, const double* Y, const int Count, int32* OutQ, int32* OutR) const
+{
+    HexBatchConversion::WorldToHex(X, Y, Count, OuterTileSize, OutQ, OutR);
 }
 
 FractionalHex AHexGridManager::LocationToFractionalHex(const FVector& Location) const
@@ -180,30 +960,16 @@ FractionalHex AHexGridManager::LocationToFractionalHex(const FVector& Location)
 	return FractionalHex(q, r, -q - r);
 }
 
-FractionalHex AHexGridManager::LerpHex(Hex a, Hex b, double t)
-{
-    return FractionalHex(PreciseLerp(a.Q, b.Q, t),
-                         PreciseLerp(a.R, b.R, t),
-                         PreciseLerp(a.S, b.S, t));
-}
-
-float AHexGridManager::PreciseLerp(double a, double b, double t)
-{
-    return a * (1-t) + b * t;
-    /* better for floating point precision than
-       a + (b - a) * t, which is what I usually write */
-}
-
 std::vector<Hex> AHexGridManager::GetHexLine(const Hex& StartHex, const Hex& EndHex)
 {
-    const int HexDistance = Distance(StartHex, EndHex);
+    const int HexDistance = Hex::Distance(StartHex, EndHex);
     
     std::vector<Hex> Results = {};
     double Step = 1.0 / FMath::Max(HexDistance, 1);
 
     for (int i = 0; i <= HexDistance; i++)
     {
-        Results.push_back(HexRound(LerpHex(StartHex, EndHex, Step * i)));
+        Results.push_back(Hex::Round(Hex::Lerp(StartHex, EndHex, Step * i)));
     }
 
     return Results;
@@ -318,156 +1084,299 @@ std::vector<Hex> AHexGridManager::GetHexLine(const Hex& StartHex, const Hex& End
 //     return Path;
 // }
 
-// red blob games
-std::vector<Hex> AHexGridManager::GetShortestPath(const Hex& Start, const Hex& End)
+std::vector<Hex> AHexGridManager::GetShortestPath(const Hex& Start, const Hex& End)
+{
+    std::vector<Hex> Path;
+    GetShortestPath(Start, End, Path);
+    return Path;
+}
+
+bool AHexGridManager::CanReach(const Hex& Start, const Hex& End)
+{
+    // Regions are built with the terrain, every path query goes through here first
+    return IsTerrainReady() && Regions.CanReach(Start, End);
+}
+
+bool AHexGridManager::GetShortestPath(const Hex& Start, const Hex& End, std::vector<Hex>& OutPath, const HexSearchSettings& Settings)
+{
+    // Leaves the streamed window, search the chunks between both ends instead
+    if (StreamChunks && !(Terrain.GetLayout().IsValid(Start) && Terrain.GetLayout().IsValid(End)))
+    {
+        const HexTerrain* Window = LoadPathWindow(Start, End);
+        OutPath.clear();
+        return Window && HexPathfinder::FindShortestPath(*Window, SearchContext, Start, End, OutPath, WithoutLandmarks(Settings));
+    }
+
+    if (!CanReach(Start, End))
+    {
+        OutPath.clear();
+        return false;
+    }
+
+    if (Settings.Heuristic == EHexHeuristic::Landmarks && Landmarks.Dirty)
+    {
+        Landmarks.Build(Terrain, LandmarkCount, SearchContext);
+    }
+
+    return HexPathfinder::FindShortestPath(Terrain, SearchContext, Start, End, OutPath, Settings, &Landmarks);
+}
+
+bool AHexGridManager::GetShortestPath(const Hex& Start, const Hex& End, HexPath& OutPath, const HexSearchSettings& Settings)
+{
+    // Leaves the streamed window, search the chunks between both ends instead
+    if (StreamChunks && !(Terrain.GetLayout().IsValid(Start) && Terrain.GetLayout().IsValid(End)))
+    {
+        const HexTerrain* Window = LoadPathWindow(Start, End);
+        OutPath.Clear();
+        return Window && HexPathfinder::FindShortestPath(*Window, SearchContext, Start, End, OutPath, WithoutLandmarks(Settings));
+    }
+
+    if (!CanReach(Start, End))
+    {
+        OutPath.Clear();
+        return false;
+    }
+
+    if (Settings.Heuristic == EHexHeuristic::Landmarks && Landmarks.Dirty)
+    {
+        Landmarks.Build(Terrain, LandmarkCount, SearchContext);
+    }
+
+    return HexPathfinder::FindShortestPath(Terrain, SearchContext, Start, End, OutPath, Settings, &Landmarks);
+}
+
+void AHexGridManager::GetShortestPaths(const std::vector<HexPathQuery>& Queries, HexPathBatch& OutBatch, const int ThreadCount, const HexSearchSettings& Settings)
 {
-    PriorityQueue Frontier;
-    Frontier.put(Start, 0);
+    // Region lookups compress paths, so they stay on this thread
+    BatchSkip.resize(Queries.size());
+    for (size_t i = 0; i < Queries.size(); i++)
+    {
+        BatchSkip[i] = CanReach(Queries[i].Start, Queries[i].End) ? 0 : 1;
+    }
 
-    std::vector<Hex> Path;
-    std::unordered_map<Hex, Hex> CameFrom;
-    std::unordered_map<Hex, double> CostSoFar;
+    if (Settings.Heuristic == EHexHeuristic::Landmarks && Landmarks.Dirty && IsTerrainReady())
+    {
+        Landmarks.Build(Terrain, LandmarkCount, SearchContext);
+    }
 
-    std::vector<Hex> Line = GetHexLine(Start, End);
-    
-    CameFrom[Start] = Start;
-    CostSoFar[Start] = 0;
+    BatchPathfinder.Solve(Terrain, Queries, BatchSkip, OutBatch, ThreadCount, Settings, &Landmarks);
+}
+
+int AHexGridManager::RequestPathAsync(const Hex& Start, const Hex& End, const EHexPathPriority Priority, HexPathCallback OnComplete,
+    const uint32 Channel, const HexSearchSettings& Settings)
+{
+    return PathService.RequestPath(Start, End, Priority, MoveTemp(OnComplete), Channel, Settings);
+}
+
+void AHexGridManager::CancelPathRequest(const int Handle)
+{
+    PathService.Cancel(Handle);
+}
+
+int AHexGridManager::RequestPathSliced(const Hex& Start, const Hex& End, HexPathCallback OnComplete, const HexSearchSettings& Settings)
+{
+    SlicedPathRequest Request;
+    Request.Handle = NextSlicedHandle++;
+    Request.OnComplete = MoveTemp(OnComplete);
+
+    if (IdleSlicedSearches.empty())
+    {
+        Request.Search = std::make_unique<HexTimeSlicedSearch>();
+    }
+    else
+    {
+        Request.Search = std::move(IdleSlicedSearches.back());
+        IdleSlicedSearches.pop_back();
+    }
+
+    Request.Search->Start(&Terrain, Start, End, Settings, &Landmarks);
 
-    // Find End Hex
-    while (!Frontier.empty())
+    // Finishes on the next Tick without expanding anything
+    if (!CanReach(Start, End))
     {
-        Hex Current = Frontier.get();
+        Request.Search->Fail();
+    }
+
+    SlicedPaths.push_back(std::move(Request));
+    return SlicedPaths.back().Handle;
+}
 
-        if (Current == End)
+void AHexGridManager::CancelSlicedPath(const int Handle)
+{
+    for (auto It = SlicedPaths.begin(); It != SlicedPaths.end(); ++It)
+    {
+        if (It->Handle == Handle)
         {
-            break;
+            IdleSlicedSearches.push_back(std::move(It->Search));
+            SlicedPaths.erase(It);
+            return;
         }
+    }
+}
 
-        for (Hex Next : GetNeighbors(Current))
+float AHexGridManager::GetSlicedPathProgress(const int Handle) const
+{
+    for (const SlicedPathRequest& Request : SlicedPaths)
+    {
+        if (Request.Handle == Handle)
         {
-            if (HexTileMap.count(Next) == 0)
-            {
-                continue;
-            }
+            return Request.Search->GetProgress();
+        }
+    }
 
-            AHexTile* Tile = GetTileByHex(Next);
-            if (!Tile || Tile->TileType == EHexTypes::Invalid || Tile->TileType == EHexTypes::Blocked)
-            {
-                continue;
-            }
-            
-            double NewCost = CostSoFar[Current] + GetHexCost(Next);
+    return 1.f;
+}
+
+void AHexGridManager::UpdateSlicedPaths()
+{
+    // A new grid is being built, searches restart once its terrain is ready
+    if (SlicedPaths.empty() || !IsTerrainReady())
+    {
+        return;
+    }
+
+    bool NeedsLandmarks = false;
+    for (const SlicedPathRequest& Request : SlicedPaths)
+    {
+        NeedsLandmarks |= Request.Search->IsRunning() && Request.Search->UsesLandmarks();
+    }
 
-            if (std::find(Line.begin(), Line.end(), Current) != Line.end())
+    if (NeedsLandmarks && Landmarks.Dirty)
+    {
+        Landmarks.Build(Terrain, LandmarkCount, SearchContext);
+    }
+
+    // Round robin, every running search gets a turn until the frame budget is spent
+    const double Deadline = FPlatformTime::Seconds() + SlicedPathBudgetMicroseconds * 1e-6;
+    bool AnyRunning = true;
+    while (AnyRunning && FPlatformTime::Seconds() < Deadline)
+    {
+        AnyRunning = false;
+        for (SlicedPathRequest& Request : SlicedPaths)
+        {
+            const double Remaining = (Deadline - FPlatformTime::Seconds()) * 1e6;
+            if (Remaining <= 0)
             {
-                NewCost -= 0.0001;
+                break;
             }
 
-            if (CostSoFar.find(Next) == CostSoFar.end() || NewCost < CostSoFar[Next])
+            if (Request.Search->IsRunning())
             {
-                CostSoFar[Next] = NewCost;
-                double Priority = NewCost + ManhattanDistance(Next, End);
-                Frontier.put(Next, Priority);
-                CameFrom[Next] = Current;
+                AnyRunning |= Request.Search->Step(SlicedPathExpansionsPerTurn, Remaining) == EHexSearchState::Running;
             }
         }
     }
 
-    Hex Current = End;
-    if (CameFrom.find(End) == CameFrom.end())
+    // Take the finished requests out first, callbacks may start or cancel requests
+    FinishedSlicedPaths.clear();
+    for (size_t i = 0; i < SlicedPaths.size(); )
     {
-        return Path; // no path can be found
+        if (SlicedPaths[i].Search->IsRunning())
+        {
+            i++;
+            continue;
+        }
+
+        FinishedSlicedPaths.push_back(std::move(SlicedPaths[i]));
+        SlicedPaths.erase(SlicedPaths.begin() + i);
     }
 
-    // Generate path
-    while (Current != Start)
+    for (SlicedPathRequest& Request : FinishedSlicedPaths)
     {
-        Path.push_back(Current);
-        Current = CameFrom[Current];
+        const bool Found = Request.Search->GetPath(SlicedPathBuffer);
+        if (Request.OnComplete)
+        {
+            Request.OnComplete(Request.Handle, Found, SlicedPathBuffer);
+        }
+        IdleSlicedSearches.push_back(std::move(Request.Search));
     }
-    
-    Path.push_back(Start); // optional
-    std::reverse(Path.begin(), Path.end());
+    FinishedSlicedPaths.clear();
+}
 
-    Current = End;
-    Path.push_back(Current);
-    while (Current != Start)
+bool AHexGridManager::GetIncrementalPath(const Hex& Start, const Hex& End, std::vector<Hex>& OutPath)
+{
+    if (!CanReach(Start, End))
     {
-        Current = CameFrom[Current];
-        Path.push_back(Current);
+        OutPath.clear();
+        return false;
     }
-    std::reverse(Path.begin(), Path.end());
 
-    return Path;
+    return IncrementalPlanner.FindPath(Start, End, OutPath);
 }
 
-Hex AHexGridManager::HexRound(const FractionalHex h) const
+bool AHexGridManager::GetIncrementalPath(const Hex& Start, const Hex& End, HexPath& OutPath)
 {
-	int q = int(round(h.Q));
-	int r = int(round(h.R));
-	int s = int(round(h.S));
-	double q_diff = abs(q - h.Q);
-	double r_diff = abs(r - h.R);
-	double s_diff = abs(s - h.S);
-	if (q_diff > r_diff && q_diff > s_diff)
-	{
-		q = -r - s;
-	}
-	else if (r_diff > s_diff)
-	{
-		r = -q - s;
-	}
-	else
-	{
-		s = -q - r;
-	}
-	
-	return Hex(q, r, s);
-}
+    if (!CanReach(Start, End))
+    {
+        OutPath.Clear();
+        return false;
+    }
 
-Hex AHexGridManager::Add(const Hex A, const Hex B)
-{
-	return Hex(A.Q + B.Q, A.R + B.R, A.S + B.S);
+    return IncrementalPlanner.FindPath(Start, End, OutPath);
 }
 
-Hex AHexGridManager::Subtract(const Hex A, const Hex B)
+bool AHexGridManager::GetHierarchicalPath(const Hex& Start, const Hex& End, std::vector<Hex>& OutPath)
 {
-	return Hex(A.Q - B.Q, A.R - B.R, A.S - B.S);
-}
+    if (!CanReach(Start, End))
+    {
+        OutPath.clear();
+        return false;
+    }
 
-Hex AHexGridManager::Multiply(const Hex Tile, const int Multiplier)
-{
-	return Hex(Tile.Q * Multiplier, Tile.R * Multiplier, Tile.S * Multiplier);
+    return ClusterGraph.FindPath(Start, End, OutPath);
 }
 
-Hex AHexGridManager::Divide(const Hex Tile, const int Divisor)
+const HexFlowField* AHexGridManager::GetFlowField(const Hex& Goal)
 {
-	return Hex(Tile.Q / Divisor, Tile.R / Divisor, Tile.S / Divisor);
-}
+    const int GoalIndex = Terrain.GetLayout().IndexOf(Goal);
+    if (GoalIndex == INDEX_NONE || FlowFields.empty() || !IsTerrainReady())
+    {
+        return nullptr;
+    }
 
-int AHexGridManager::Length(const Hex Tile)
-{
-	return (
-		int(FMath::Abs(Tile.Q) +
-		FMath::Abs(Tile.R) +
-		FMath::Abs(Tile.S)) / 2);
+    // Reuse the field of this goal, otherwise take the oldest one
+    HexFlowField* Field = &FlowFields[0];
+    for (HexFlowField& Candidate : FlowFields)
+    {
+        if (Candidate.GetGoalIndex() == GoalIndex)
+        {
+            Field = &Candidate;
+            break;
+        }
+
+        if (Candidate.LastUsed < Field->LastUsed)
+        {
+            Field = &Candidate;
+        }
+    }
+
+    if (Field->Dirty || Field->GetGoalIndex() != GoalIndex)
+    {
+        Field->Build(Terrain, GoalIndex, SearchContext);
+    }
+
+    Field->LastUsed = ++FlowFieldClock;
+    return Field;
 }
 
-int AHexGridManager::ManhattanDistance(const Hex& A, const Hex& B)
+const HexMovementRange& AHexGridManager::GetMovementRange(const Hex& Start, const float Budget)
 {
-    return FMath::Abs(A.Q - B.Q) + FMath::Abs(A.R - B.R) + FMath::Abs(A.S - B.S);
+    // A negative budget leaves the range empty until the terrain is ready
+    MovementRange.Build(Terrain, SearchContext, Start, IsTerrainReady() ? Budget : -1.f);
+    return MovementRange;
 }
 
-int AHexGridManager::Distance(const Hex& A, const Hex& B)
+bool AHexGridManager::GetFlowStep(const Hex& From, const Hex& Goal, Hex& OutNext)
 {
-	return Length(Subtract(A, B));
+    const HexFlowField* Field = GetFlowField(Goal);
+    return Field && Field->GetNextHex(From, OutNext);
 }
 
 std::vector<Hex> AHexGridManager::GetHexesInRange(const Hex StartingHex, const int Range) const
 {
 	// declare vector
 	std::vector<Hex> Result;
-	Result.reserve(GetHexCountForRange(Range));
+	Result.reserve(Hex::GetHexCountForRange(Range));
 
 	for (int q = -Range; q <= Range; q++)
 	{
@@ -475,53 +1384,159 @@ std::vector<Hex> AHexGridManager::GetHexesInRange(const Hex StartingHex, const i
 		const int r2 = std::min(Range, -q + Range);
 		for (int r = r1; r <= r2; r++)
 		{
-			Result.push_back(Add(StartingHex, Hex(q, r)));
+			Result.push_back(Hex::Add(StartingHex, Hex(q, r)));
 		}
 	}
 
 	return Result;
 }
 
-int AHexGridManager::GetHexCountForRange(const int Range)
+void AHexGridManager::SelectHexes(const std::vector<Hex>& Hexes)
 {
-	return 3 * Range * (Range + 1);
+    for (const Hex& H : Hexes)
+    {
+        SelectTile(Terrain.GetLayout().IndexOf(H));
+    }
 }
 
-void AHexGridManager::SelectHexes(const std::vector<Hex>& Hexes)
+void AHexGridManager::SelectHexes(const HexPath& Path)
+{
+    for (const Hex& H : Path)
+    {
+        SelectTile(Terrain.GetLayout().IndexOf(H));
+    }
+}
+
+void AHexGridManager::SelectHexes(const HexMovementRange& Range)
+{
+    for (const HexReachableTile& Tile : Range.GetTiles())
+    {
+        SelectTile(Tile.Index);
+    }
+}
+
+void AHexGridManager::UnselectHexes()
+{
+    for (const int Index : SelectedTiles)
+    {
+        SetTileSelected(Index, false);
+    }
+
+    SelectedTiles.clear();
+}
+
+void AHexGridManager::SetSelection(const std::vector<Hex>& Hexes)
+{
+    BeginSelection();
+    for (const Hex& H : Hexes)
+    {
+        MarkSelected(Terrain.GetLayout().IndexOf(H));
+    }
+    EndSelection();
+}
+
+void AHexGridManager::SetSelection(const HexPath& Path)
+{
+    BeginSelection();
+    for (const Hex& H : Path)
+    {
+        MarkSelected(Terrain.GetLayout().IndexOf(H));
+    }
+    EndSelection();
+}
+
+void AHexGridManager::SetSelection(const HexMovementRange& Range)
+{
+    BeginSelection();
+    for (const HexReachableTile& Tile : Range.GetTiles())
+    {
+        MarkSelected(Tile.Index);
+    }
+    EndSelection();
+}
+
+void AHexGridManager::BeginSelection()
+{
+    NextSelectedTiles.clear();
+
+    SelectionGeneration++;
+    if (SelectionGeneration == 0)
+    {
+        std::fill(SelectionMark.begin(), SelectionMark.end(), 0);
+        SelectionGeneration = 1;
+    }
+}
+
+void AHexGridManager::MarkSelected(const int Index)
+{
+    if (Index != INDEX_NONE && SelectionMark[Index] != SelectionGeneration)
+    {
+        SelectionMark[Index] = SelectionGeneration;
+        NextSelectedTiles.push_back(Index);
+    }
+}
+
+void AHexGridManager::EndSelection()
 {
-    for (Hex Hex : Hexes)
+    // Only tiles that leave or enter the selection get redrawn
+    for (const int Index : SelectedTiles)
     {
-        const AHexTile* Tile = GetTileByHex(Hex);
-        if (Tile)
+        if (SelectionMark[Index] != SelectionGeneration)
         {
-            Tile->Select(SelectedMaterial);
-            SelectedHexes.push_back(Hex);
+            SetTileSelected(Index, false);
+        }
+    }
+
+    for (const int Index : NextSelectedTiles)
+    {
+        if (!TileSelected[Index])
+        {
+            SetTileSelected(Index, true);
         }
     }
+
+    std::swap(SelectedTiles, NextSelectedTiles);
 }
 
-void AHexGridManager::UnselectHexes()
+void AHexGridManager::SelectTile(const int Index)
+{
+    if (Index != INDEX_NONE && !TileSelected[Index])
+    {
+        SetTileSelected(Index, true);
+        SelectedTiles.push_back(Index);
+    }
+}
+
+void AHexGridManager::SetTileSelected(const int Index, const bool Selected)
 {
-    for (Hex Hex : SelectedHexes)
+    TileSelected[Index] = Selected ? 1 : 0;
+    RenderUpdateCount++;
+
+    if (UsesInstances())
+    {
+        SetInstanceData(Index, InstanceDataSelected, Selected ? 1.f : 0.f);
+    }
+    else if (const AHexTile* Tile = HexTiles[Index])
     {
-        const AHexTile* Tile = GetTileByHex(Hex);
-        if (Tile)
+        if (Selected)
+        {
+            Tile->Select(SelectedMaterial);
+        }
+        else
         {
             Tile->Unselect();
         }
     }
-
-    SelectedHexes.clear();
 }
 
 float AHexGridManager::GetFromStartCost(const Hex& Start, const Hex& Current)
 {
-    return Distance(Start, Current);
+    return Hex::Distance(Start, Current);
 }
 
 float AHexGridManager::GetToEndCost(const Hex& Current, const Hex& End)
 {
-    return Distance(Current, End);
+    return Hex::Distance(Current, End);
 }
 
 float AHexGridManager::GetTotalCost(const Hex& Start, const Hex& Current, const Hex& End)
@@ -531,13 +1546,7 @@ float AHexGridManager::GetTotalCost(const Hex& Start, const Hex& Current, const
 
 float AHexGridManager::GetTileCost(const Hex& Hex)
 {
-    EHexTypes Type = HexTileMap[Hex]->TileType;
-    if (HexTileCostMap.count(Type))
-    {
-        return HexTileCostMap[Type];
-    }
-
-    return 100;
+    return GetTypeCost(GetHexType(Hex));
 }
 
 // optimized
@@ -579,11 +1588,181 @@ float AHexGridManager::GetTileCost(const Hex& Hex)
 
 float AHexGridManager::GetHexCost(const Hex& Tile)
 {
-    EHexTypes Type = HexTileMap[Tile]->TileType;
-    if (HexTileCostMap.count(Type))
+    const int Index = Terrain.GetLayout().IndexOf(Tile);
+    if (Index != INDEX_NONE)
+    {
+        return Terrain.GetCost(Index);
+    }
+
+    return UnknownTileCost;
+}
+
+float AHexGridManager::GetTypeCost(const EHexTypes Type) const
+{
+    const auto It = HexTileCostMap.find(Type);
+    if (It != HexTileCostMap.end())
+    {
+        return It->second;
+    }
+
+    return UnknownTileCost;
+}
+
+float AHexGridManager::GetMinTileCost() const
+{
+    float MinCost = TNumericLimits<float>::Max();
+    for (const auto& Entry : HexTileCostMap)
+    {
+        MinCost = FMath::Min(MinCost, Entry.second);
+    }
+
+    return HexTileCostMap.empty() ? 1.f : MinCost;
+}
+
+EHexTypes AHexGridManager::GetHexType(const Hex& H) const
+{
+    const int Index = Terrain.GetLayout().IndexOf(H);
+    if (Index != INDEX_NONE && IsTerrainReady())
+    {
+        return Terrain.GetType(Index);
+    }
+
+    return EHexTypes::Invalid;
+}
+
+void AHexGridManager::SetHexType(const Hex& H, const EHexTypes Type)
+{
+    // The generated types would overwrite it, FinishTerrainStage replays it instead
+    if (!IsTerrainReady())
+    {
+        PendingEdits.emplace_back(H, Type);
+        return;
+    }
+
+    // Hexes outside a fixed grid don't exist, streamed ones are kept by the chunk store
+    if (!StreamChunks && !Terrain.GetLayout().IsValid(H))
+    {
+        return;
+    }
+
+    // Outside of a tile edit every change is its own undo step
+    BeginTileEdit();
+    EditJournal.Record(H, StreamChunks ? ChunkStore.GetType(H) : GetHexType(H), Type);
+    EndTileEdit();
+}
+
+void AHexGridManager::SetHexTypes(const std::vector<std::pair<Hex, EHexTypes>>& Types)
+{
+    BeginTileEdit();
+    for (const std::pair<Hex, EHexTypes>& Edit : Types)
+    {
+        SetHexType(Edit.first, Edit.second);
+    }
+    EndTileEdit();
+}
+
+void AHexGridManager::BeginTileEdit()
+{
+    EditJournal.Begin();
+}
+
+void AHexGridManager::EndTileEdit()
+{
+    if (const std::vector<HexTileEdit>* Edits = EditJournal.End())
+    {
+        ApplyTileEdits(*Edits, false);
+    }
+}
+
+bool AHexGridManager::UndoTileEdit()
+{
+    // Undoing under an open edit would record over the history being walked
+    const std::vector<HexTileEdit>* Edits = EditJournal.IsRecording() || !IsTerrainReady() ? nullptr : EditJournal.Undo();
+    if (!Edits)
+    {
+        return false;
+    }
+
+    ApplyTileEdits(*Edits, true);
+    return true;
+}
+
+bool AHexGridManager::RedoTileEdit()
+{
+    const std::vector<HexTileEdit>* Edits = EditJournal.IsRecording() || !IsTerrainReady() ? nullptr : EditJournal.Redo();
+    if (!Edits)
+    {
+        return false;
+    }
+
+    ApplyTileEdits(*Edits, false);
+    return true;
+}
+
+void AHexGridManager::ApplyTileEdits(const std::vector<HexTileEdit>& Edits, const bool Revert)
+{
+    if (Edits.empty())
+    {
+        return;
+    }
+
+    // Past an eighth of the grid rebuilding the graphs once is cheaper than patching them per tile
+    const bool Rebuild = static_cast<int64>(Edits.size()) * 8 > Terrain.Num();
+
+    for (const HexTileEdit& Edit : Edits)
+    {
+        const Hex H = Edit.Tile.ToHex();
+        const EHexTypes Type = Revert ? Edit.OldType : Edit.NewType;
+
+        // The store keeps the edit once the chunk leaves the window
+        if (StreamChunks)
+        {
+            ChunkStore.SetType(H, Type);
+        }
+
+        const int Index = Terrain.GetLayout().IndexOf(H);
+        if (Index == INDEX_NONE)
+        {
+            continue;
+        }
+
+        Terrain.SetTile(Index, Type, GetTypeCost(Type));
+        if (!Rebuild)
+        {
+            IncrementalPlanner.OnTileChanged(Index);
+            ClusterGraph.OnTileChanged(Index);
+            Regions.OnTileChanged(Index);
+        }
+
+        // Tile actor or instance is only a visual. Instances only write custom data here,
+        // Tick sends their render state once for the whole batch.
+        if (AHexTile* Tile = HexTiles[Index])
+        {
+            Tile->SetType(Type, GetMaterial(Type));
+            RenderUpdateCount++;
+
+            // SetType swapped the material, keep the highlight
+            if (TileSelected[Index])
+            {
+                Tile->Select(SelectedMaterial);
+            }
+        }
+        else if (UsesInstances())
+        {
+            SetInstanceData(Index, InstanceDataType, static_cast<float>(Type));
+        }
+    }
+
+    if (Rebuild)
     {
-        return HexTileCostMap[Type];
+        BuildTerrainGraphs();
     }
 
-    return 1000.f;
-}
\ No newline at end of file
+    // Also bumps TerrainVersion, which streamed path windows check
+    InvalidateTerrainCaches();
+
+    if (ReplicatesTerrain())
+    {
+        ReplicateChunks(Edits);
+    }
+}
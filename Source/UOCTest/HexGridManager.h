@@ -2,17 +2,39 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <queue>
 #include <unordered_set>
 
 #include "CoreMinimal.h"
 #include "Hex.h"
+#include "HexBatchConversion.h"
+#include "HexBatchPathfinder.h"
+#include "HexChunkStore.h"
+#include "HexClusterGraph.h"
+#include "HexEditJournal.h"
+#include "HexFlowField.h"
+#include "HexGridStorage.h"
+#include "HexLandmarks.h"
+#include "HexIncrementalPlanner.h"
+#include "HexKey.h"
+#include "HexMapFile.h"
+#include "HexMovementRange.h"
+#include "HexPathService.h"
+#include "HexPathfinder.h"
+#include "HexRegions.h"
+#include "HexTerrain.h"
+#include "HexTerrainGenerator.h"
+#include "HexTerrainReplication.h"
 #include "HexTile.h"
+#include "HexTimeSlicedSearch.h"
 #include "GameFramework/Actor.h"
 #include "HexGridManager.generated.h"
 
 struct Hex;
+class UHierarchicalInstancedStaticMeshComponent;
 
 // Point for Grid Layout
 struct Point
@@ -21,24 +43,11 @@ struct Point
 	Point(double x_, double y_): X(x_), Y(y_) {}
 };
 
-// Fraction
-struct FractionalHex
-{
-	const double Q, R, S;
-	FractionalHex(double q_, double r_, double s_)
-	: Q(q_), R(r_), S(s_) {}
-};
-
-
-// combines two hashes
-inline size_t hexHashCombine(int h1, int h2)
-{
-    return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
-}
 
+// hashes the packed coordinates, S follows from Q and R
 inline size_t hexToHash(const Hex& h)
 {
-    return hexHashCombine(hexHashCombine(h.Q, h.R), h.S);
+    return static_cast<size_t>(HexKey(h).Hash());
 }
 
 namespace std
@@ -76,6 +85,9 @@ private:
     float TileCost = 0;
 };
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnHexGridBuildProgress, float, Progress);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnHexGridReady);
+
 UCLASS()
 class UOCTEST_API AHexGridManager : public AActor
 {
@@ -88,17 +100,55 @@ public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+    // A replicated terrain chunk arrived on a client, applied with the others on the next Tick
+    void OnTerrainChunkReplicated(const FHexTerrainChunk& Item);
+
+    // Encoded size of the whole replicated terrain, what a joining client downloads
+    int64 GetReplicatedTerrainBytes() const { return TerrainChunks.GetEncodedBytes(); }
+
+    // Join size the snapshot should stay under, JoinSnapshotBytesPerTile for every tile of the grid
+    int64 GetJoinSnapshotTargetBytes() const { return static_cast<int64>(JoinSnapshotBytesPerTile * Terrain.Num()); }
+
+    // Fraction of tiles registered for rendering, broadcast every frame while the grid is built
+    UPROPERTY(BlueprintAssignable, Category = "Hex Grid")
+    FOnHexGridBuildProgress OnGridBuildProgress;
+
+    // Broadcast once every tile is registered
+    UPROPERTY(BlueprintAssignable, Category = "Hex Grid")
+    FOnHexGridReady OnGridReady;
+
+    EHexGridBuildStage GetBuildStage() const { return BuildStage; }
+
+    // Tile types are final. Before that path queries fail, edits are held back and async requests wait.
+    bool IsTerrainReady() const { return BuildStage == EHexGridBuildStage::Registering || BuildStage == EHexGridBuildStage::Ready; }
+
+    bool IsGridReady() const { return BuildStage == EHexGridBuildStage::Ready; }
+
+    // Writes the tile types of the grid, relative paths start in the project Saved directory.
+    // Streamed grids keep their tiles in the chunk store and can't be saved.
+    bool SaveMap(const FString& Path);
+
+    // Replaces the grid with a saved one, built in stages like at startup. Returns false for
+    // streamed grids, while a build is running and when the file can't be opened.
+    bool LoadMap(const FString& Path);
+
+    // Replaces every tile type with the procedural terrain of Seed, edits are lost.
+    // Returns false while the grid is still being built.
+    bool RegenerateTerrain(int32 Seed);
+
 	// World coordinate to Hex
 	Hex WorldToHex(const FVector& Location) const;
 
-	// World location to fractional Hex -> used to find Hex
-	FractionalHex LocationToFractionalHex(const FVector& Location) const;
+    // WorldToHex of Count points given as separate X and Y arrays, same hexes as the scalar version
+    void WorldToHexes(const double* X, const double* Y, int Count, int32* OutQ, int32* OutR) const;
 
-    // Lerp hex
-    FractionalHex LerpHex(Hex a, Hex b, double t);
+    // Distance from a hex center to its corners
+    float GetOuterTileSize() const { return OuterTileSize; }
 
-    // Better precision lerp
-    static float PreciseLerp(double a, double b, double t);
+	// World location to fractional Hex -> used to find Hex
+	FractionalHex LocationToFractionalHex(const FVector& Location) const;
 
     // Get line in hexes
     std::vector<Hex> GetHexLine(const Hex& StartHex, const Hex& EndHex);
@@ -106,30 +156,89 @@ public:
     // Get path in hexes
     std::vector<Hex> GetShortestPath(const Hex& Start, const Hex& End);
 
+    // False when End lies in another region than Start, answered without a search
+    bool CanReach(const Hex& Start, const Hex& End);
+
+    // Get path in hexes into a reused vector, no allocations once warmed up. Returns false when there is no path.
+    bool GetShortestPath(const Hex& Start, const Hex& End, std::vector<Hex>& OutPath, const HexSearchSettings& Settings = HexSearchSettings());
+
+    // Get path as packed steps, iterate it to visit the hexes
+    bool GetShortestPath(const Hex& Start, const Hex& End, HexPath& OutPath, const HexSearchSettings& Settings = HexSearchSettings());
+
+    // Get paths for many start/goal pairs at once, solved in parallel into one buffer.
+    // ThreadCount 0 uses every task graph worker.
+    void GetShortestPaths(const std::vector<HexPathQuery>& Queries, HexPathBatch& OutBatch, int ThreadCount = 0,
+        const HexSearchSettings& Settings = HexSearchSettings());
+
+    // Get path on a worker thread, OnComplete runs on the game thread during Tick.
+    // A non zero Channel cancels the older request of the same channel.
+    int RequestPathAsync(const Hex& Start, const Hex& End, EHexPathPriority Priority, HexPathCallback OnComplete,
+        uint32 Channel = 0, const HexSearchSettings& Settings = HexSearchSettings());
+
+    void CancelPathRequest(int Handle);
+
+    // Get path on the game thread, spread over as many frames as it needs. Tick advances every
+    // pending request within SlicedPathBudget and OnComplete runs there once the search is done.
+    int RequestPathSliced(const Hex& Start, const Hex& End, HexPathCallback OnComplete, const HexSearchSettings& Settings = HexSearchSettings());
+
+    // A cancelled request never calls back
+    void CancelSlicedPath(int Handle);
+
+    // Between 0 and 1, 1 for unknown or finished requests
+    float GetSlicedPathProgress(int Handle) const;
+
+    // Nodes expanded by the last GetShortestPath, to compare heuristics per call site
+    int GetLastNodesExpanded() const { return SearchContext.NodesExpanded; }
+
+    // Get path for a live preview, repairs the previous search when only End or a few tiles changed
+    bool GetIncrementalPath(const Hex& Start, const Hex& End, std::vector<Hex>& OutPath);
+    bool GetIncrementalPath(const Hex& Start, const Hex& End, HexPath& OutPath);
+
+    // Get path through the cluster graph, for long queries on big maps
+    bool GetHierarchicalPath(const Hex& Start, const Hex& End, std::vector<Hex>& OutPath);
+
+    // Flow field towards Goal, built on first use and cached until a tile changes.
+    // The pointer stays valid until MaxFlowFields other goals have been requested.
+    const HexFlowField* GetFlowField(const Hex& Goal);
+
+    // Every hex reachable from Start for at most Budget movement cost, with its cost and predecessor.
+    // The result is reused by the next call.
+    const HexMovementRange& GetMovementRange(const Hex& Start, float Budget);
+
+    // Next hex on the way to Goal, returns false at the goal or when it can't be reached
+    bool GetFlowStep(const Hex& From, const Hex& Goal, Hex& OutNext);
+
     // Returns associated blueprint to Hex 
-	AHexTile* GetTileByHex(Hex& H);
+	AHexTile* GetTileByHex(const Hex& H);
 
 	// Returns 2D point
 	Point HexToWorldPoint(const Hex Tile) const;
+    static Point HexToWorldPoint(const Hex Tile, float HorizontalSpacing, float VerticalSpacing);
 
 	// Returns 3D point
 	FVector HexToWorldLocation(Hex Tile) const;
 	
-	static int Length(const Hex Tile);
-    static int ManhattanDistance(const Hex& A, const Hex& B);
-
-    static int Distance(const Hex& A, const Hex& B);
-
 	// returns a vector of Hexes in a desired Rangee
 	std::vector<Hex> GetHexesInRange(Hex StartingHex, int Range) const;
 	
-	// Returns the number of hexes in a desired Range
-	static int GetHexCountForRange(int Range);
-	
 	void SelectHexes(const std::vector<Hex>& Hexes);
+    void SelectHexes(const HexPath& Path);
+    void SelectHexes(const HexMovementRange& Range);
 	
 	void UnselectHexes();
 
+    // Replaces the selection. Only tiles that enter or leave it are redrawn,
+    // so setting the same selection again costs no render updates.
+    void SetSelection(const std::vector<Hex>& Hexes);
+    void SetSelection(const HexPath& Path);
+    void SetSelection(const HexMovementRange& Range);
+
+    // Material and render state updates made during the previous frame
+    int GetRenderUpdatesLastFrame() const { return RenderUpdatesLastFrame; }
+
+    // Changes whenever a tile type changes, lets callers skip queries on unchanged terrain
+    uint32 GetTerrainVersion() const { return TerrainVersion; }
+
     // Calculate costs
     float GetFromStartCost(const Hex& Start, const Hex& Current);
     float GetToEndCost(const Hex& Current, const Hex& End);
@@ -141,6 +250,35 @@ public:
     // Old cost calculation
     float GetHexCost(const Hex& Tile);
 
+    // Cost of tiles outside the grid and of types without a HexTileCostMap entry
+    static constexpr float UnknownTileCost = 1000.f;
+
+    // Movement cost of a tile type, UnknownTileCost when the type has no cost entry
+    float GetTypeCost(EHexTypes Type) const;
+
+    // Cheapest entry of HexTileCostMap, used to keep heuristics admissible
+    float GetMinTileCost() const;
+
+    // Returns the terrain type of the hex, Invalid when outside of the grid or the streamed window
+    EHexTypes GetHexType(const Hex& H) const;
+
+    // Changes the terrain type and mirrors it to the tile actor. Inside a tile edit the change is only
+    // recorded, queries keep seeing the old type until the outermost EndTileEdit applies the whole edit.
+    void SetHexType(const Hex& H, EHexTypes Type);
+
+    // Changes every tile as one undo step with a single cache invalidation
+    void SetHexTypes(const std::vector<std::pair<Hex, EHexTypes>>& Types);
+
+    // Groups SetHexType calls into one undo step, a brush stroke for example. Edits nest.
+    void BeginTileEdit();
+    void EndTileEdit();
+
+    // Reverts or repeats a whole tile edit in one batch, returns false when there is nothing to undo or redo
+    bool UndoTileEdit();
+    bool RedoTileEdit();
+
+    const HexTerrain& GetTerrain() const { return Terrain; }
+
     // Return Material of type
     UMaterialInstance* GetMaterial(EHexTypes Type);
 
@@ -149,24 +287,92 @@ protected:
 	virtual void BeginPlay() override;
 
 private:
-	void GenerateGrid();
+    // Sizes the grid and computes transforms and types on worker threads, Tick takes it from there.
+    // With a Map the types come from it, a Replica leaves them Invalid until the server's chunks arrive.
+	void StartGridBuild(const HexGridLayout& Layout, TSharedPtr<HexMapFile, ESPMode::ThreadSafe> Map, bool Replica);
+
+    // Destroys the tile actors and instances before the grid is built again
+    void ClearTileVisuals();
+
+    // Advances the build by one frame
+    void UpdateGridBuild();
+
+    // Copies the computed types into the terrain and opens it for queries
+    void FinishTerrainStage();
+
+    // Spawns actors or adds instances until Deadline, returns true once every tile is registered
+    bool RegisterTiles(double Deadline);
+
+    // Applies the generation properties, tile spacings must be known
+    void InitTerrainGenerator();
+
+    FString ResolveMapPath(const FString& Path) const;
+
+    // Sets the old or new type of every edit, then invalidates the caches once
+    void ApplyTileEdits(const std::vector<HexTileEdit>& Edits, bool Revert);
+
+    // Server side, sends the layout and encodes every chunk for clients
+    void ReplicateAllChunks();
+
+    // Server side, encodes again the chunks touched by Edits, only those go out
+    void ReplicateChunks(const std::vector<HexTileEdit>& Edits);
+
+    bool ReplicatesTerrain() const { return HasAuthority() && !StreamChunks && !IsNetMode(NM_Standalone); }
+
+    UFUNCTION()
+    void OnRep_GridLayout();
 
     // Calculate and return neighbors
-    std::vector<Hex> GetNeighbors(const Hex& H);
+    HexNeighbors GetNeighbors(const Hex& H) const;
+
+    // Selection diff, tiles marked between Begin and End form the new selection
+    void BeginSelection();
+    void MarkSelected(int Index);
+    void EndSelection();
+
+    // Adds a tile to the selection
+    void SelectTile(int Index);
+
+    // Redraws a single tile
+    void SetTileSelected(int Index, bool Selected);
+
+    // Sizes every per-tile system for Layout, streamed grids take their types from the chunk store
+    void InitGrid(const HexGridLayout& Layout);
+
+    // Rebuilds the planners and regions from the current terrain
+    void BuildTerrainGraphs();
+
+    // Everything derived from the whole terrain is stale
+    void InvalidateTerrainCaches();
+
+    UHierarchicalInstancedStaticMeshComponent* CreateInstanceComponent(FName Name);
+
+    // Replaces the instances of Component with one per tile of Layout
+    void FillInstances(UHierarchicalInstancedStaticMeshComponent* Component, const HexGridLayout& Layout);
+
+    bool UsesInstances() const { return TileInstances || StreamChunks; }
+
+    // Moves the grid window when Focus entered another chunk
+    void StreamAround(const Hex& Focus);
+
+    // Gives every chunk between MinChunk and MaxChunk its instances and pools the others
+    void UpdateChunkInstances(HexKey MinChunk, HexKey MaxChunk);
+
+    // Slot in ChunkInstances, INDEX_NONE when the chunk isn't visible
+    int FindChunkInstances(HexKey Chunk) const;
+
+    // Copies the chunk store into a terrain whose layout covers whole chunks
+    void FillTerrainFromChunks(HexTerrain& Target);
+
+    // Terrain covering the chunks around Start and End, null when that is more than MaxPathChunks
+    const HexTerrain* LoadPathWindow(const Hex& Start, const Hex& End);
+
+    void SetInstanceData(int Index, int DataIndex, float Value);
 
     // Get direction between two hexes
     Hex GetHexDirection(const Hex& From, const Hex& To);
     FVector GetVectorDirection(const Hex& From, const Hex& To);
 
-    // Rounding from fractal coordinates
-	Hex HexRound(FractionalHex h) const;
-	
-	// Arithmetics
-	static Hex Add(const Hex A, const Hex B);    
-    static Hex Subtract(const Hex A, const Hex B);
-	static Hex Multiply(const Hex Tile, int Multiplier);
-	static Hex Divide(const Hex Tile, int Divisor);
-
 	// Fields
 	UPROPERTY(EditAnywhere, Category = "Hex Grid")
 	TSubclassOf<AHexTile> HexTile;
@@ -198,6 +404,26 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Hex Grid | Number of tiles")
 	bool IsFlatTopLayout = true;
 
+    // Tiles per side of a hierarchical pathfinding cluster
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Pathfinding")
+    int ClusterSize = 10;
+
+    // Number of goals that keep a cached flow field
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Pathfinding")
+    int MaxFlowFields = 8;
+
+    // Landmarks used by EHexHeuristic::Landmarks
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Pathfinding")
+    int LandmarkCount = 8;
+
+    // Game thread time all sliced path requests together may use per frame
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Pathfinding", meta = (ClampMin = "0"))
+    float SlicedPathBudgetMicroseconds = 1000.f;
+
+    // Expansions a sliced request gets before the next one has its turn
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Pathfinding", meta = (ClampMin = "1"))
+    int SlicedPathExpansionsPerTurn = 128;
+
 	UPROPERTY()
 	float TileWidth;
 
@@ -228,6 +454,111 @@ private:
 
     UPROPERTY(EditAnywhere, Category = "Hex Grid | Materials")
     UMaterialInstance* SelectedMaterial;
+
+    // Generates Water, Dirt, Grass and Blocked tiles from noise instead of filling the grid with Grass
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Generation")
+    bool ProceduralTerrain = true;
+
+    // Same seed, same map
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Generation")
+    int32 TerrainSeed = 1337;
+
+    // World units between two features of the coarsest noise octave
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Generation", meta = (ClampMin = "1"))
+    float TerrainFeatureSize = 3000.f;
+
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Generation", meta = (ClampMin = "1", ClampMax = "16"))
+    int TerrainOctaves = 4;
+
+    // Noise is in [0, 1). Tiles below WaterLevel are Water, below DirtLevel Dirt,
+    // from BlockedLevel up Blocked and Grass in between.
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Generation", meta = (ClampMin = "0", ClampMax = "1"))
+    float WaterLevel = 0.38f;
+
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Generation", meta = (ClampMin = "0", ClampMax = "1"))
+    float DirtLevel = 0.44f;
+
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Generation", meta = (ClampMin = "0", ClampMax = "1"))
+    float BlockedLevel = 0.66f;
+
+    // Tile edits kept for undo
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Editing", meta = (ClampMin = "1"))
+    int MaxUndoSteps = 64;
+
+    // Map loaded at BeginPlay instead of generating the terrain, relative paths start in the project Saved directory.
+    // Missing or damaged files fall back to generation.
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Map")
+    FString MapPath;
+
+    // Chunks that don't shrink are saved uncompressed either way
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Map")
+    EHexMapCompression MapCompression = EHexMapCompression::LZ4;
+
+    // Target size of the terrain snapshot a joining client downloads, raw types would take 1 byte per tile.
+    // Generated terrain encodes to about a quarter of that, the server warns when a snapshot goes over.
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Replication", meta = (ClampMin = "0"))
+    float JoinSnapshotBytesPerTile = 0.5f;
+
+    // Game thread time the grid build may use per frame to register tiles
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Construction", meta = (ClampMin = "0.1"))
+    float GridBuildBudgetMs = 4.f;
+
+    // Collision bodies for tile actors and instances. The camera picks tiles on the grid plane without them,
+    // only trace picking of elevated terrain needs them and thousands of bodies bloat the physics scene.
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Rendering")
+    bool TileCollision = false;
+
+    // Actors spawns an AHexTile per hex, Instanced draws the whole grid with one component
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Rendering")
+    EHexRenderMode RenderMode = EHexRenderMode::Actors;
+
+    // Mesh of every instance, the AHexTile mesh when empty
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Rendering")
+    UStaticMesh* InstancedTileMesh;
+
+    // Material of every instance. PerInstanceCustomData 0 holds the EHexTypes value,
+    // PerInstanceCustomData 1 is 1 for selected tiles and 0 otherwise.
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Rendering")
+    UMaterialInterface* InstancedTileMaterial;
+
+    // Instance i draws tile i of the layout, only created in Instanced mode
+    UPROPERTY()
+    UHierarchicalInstancedStaticMeshComponent* TileInstances;
+
+    static constexpr int InstanceDataType = 0;
+    static constexpr int InstanceDataSelected = 1;
+    static constexpr int InstanceDataCount = 2;
+
+    // Custom data changed, render state is sent once at the end of the frame
+    bool TileInstancesDirty = false;
+
+    // Streams the world in chunks around the camera instead of the fixed bounds.
+    // Streamed chunks are always drawn instanced.
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Streaming")
+    bool StreamChunks = false;
+
+    // Tiles per side of a chunk
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Streaming", meta = (ClampMin = "1"))
+    int ChunkSize = 32;
+
+    // Chunks loaded and visible on every side of the chunk under the camera
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Streaming", meta = (ClampMin = "0"))
+    int StreamRadius = 2;
+
+    // Chunks the store keeps in memory, never less than the visible window
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Streaming", meta = (ClampMin = "1"))
+    int MaxCachedChunks = 64;
+
+    // Largest rectangle of chunks a path leaving the visible window may load
+    UPROPERTY(EditAnywhere, Category = "Hex Grid | Streaming", meta = (ClampMin = "1"))
+    int MaxPathChunks = 64;
+
+    // Component per visible chunk, slots of chunks that left the window are reused
+    UPROPERTY()
+    TArray<UHierarchicalInstancedStaticMeshComponent*> ChunkInstances;
+    std::vector<HexKey> ChunkInstanceKeys;
+    std::vector<uint8> ChunkInstanceUsed;
+    std::vector<uint8> ChunkInstanceDirty;
     
 	// All directions
 	TArray<Hex> DirectionVectors = TArray
@@ -246,11 +577,120 @@ private:
         {EHexTypes::Water, 5.f},
     };
     
-	std::map<Hex, AHexTile*> HexTileMap;
+    HexGridStorage<AHexTile*> HexTiles;
+
+    // Authoritative per-tile terrain, tile actors only mirror it
+    HexTerrain Terrain;
+
+    // Scratch arrays reused by every GetShortestPath call
+    HexSearchContext SearchContext;
+
+    // Keeps its search alive between GetIncrementalPath calls
+    HexIncrementalPlanner IncrementalPlanner;
+
+    // Result of the last GetMovementRange
+    HexMovementRange MovementRange;
+
+    // Abstract graph used by GetHierarchicalPath
+    HexClusterGraph ClusterGraph;
+
+    // ALT lower bounds, rebuilt on the next landmark query after a tile changed
+    HexLandmarks Landmarks;
+
+    // Connected regions, lets unreachable queries fail before searching
+    HexRegions Regions;
+
+    // Scratch of GetShortestPaths, kept between batches
+    HexBatchPathfinder BatchPathfinder;
+    std::vector<uint8> BatchSkip;
+
+    // Async queries against terrain snapshots
+    HexPathService PathService;
+
+    HexTerrainGenerator TerrainGenerator;
+
+    HexEditJournal EditJournal;
+
+    // Grid bounds and terrain sent to clients, they never generate or load their own
+    UPROPERTY(ReplicatedUsing = OnRep_GridLayout)
+    FHexReplicatedLayout ReplicatedLayout;
+
+    UPROPERTY(Replicated)
+    FHexTerrainChunkArray TerrainChunks;
+
+    // Changes decoded from replicated chunks since the last Tick
+    std::vector<HexTileEdit> ReplicatedEdits;
+    std::vector<EHexTypes> ReplicatedChunkTypes;
+
+    // Written by the worker of the preparing stage, one entry per tile
+    struct GridBuildData
+    {
+        std::vector<FTransform> Transforms;
+        std::vector<EHexTypes> Types;
+        std::atomic<bool> Done { false };
+
+        // Set when the types came from a map file
+        bool FromMap = false;
+        bool MapDamaged = false;
+        bool MapMapped = false;
+        double MapSeconds = 0;
+        int64 MapBytes = 0;
+    };
+
+    EHexGridBuildStage BuildStage = EHexGridBuildStage::NotStarted;
+    TSharedPtr<GridBuildData, ESPMode::ThreadSafe> BuildData;
+
+    // Next tile to register
+    int BuildCursor = 0;
+
+    // Edits made before the terrain was ready, applied on top of the generated types
+    std::vector<std::pair<Hex, EHexTypes>> PendingEdits;
+
+    // Types of the streamed world, the grid is the window of chunks around StreamCenter
+    HexChunkStore ChunkStore;
+    HexKey StreamCenter;
+    bool StreamWindowValid = false;
+
+    // Chunks loaded for the last path that left the window
+    HexTerrain PathWindowTerrain;
+    uint32 PathWindowVersion = 0;
+    bool PathWindowValid = false;
+
+    struct SlicedPathRequest
+    {
+        int Handle = 0;
+        HexPathCallback OnComplete;
+        std::unique_ptr<HexTimeSlicedSearch> Search;
+    };
+
+    // Advances the sliced requests and calls back the finished ones
+    void UpdateSlicedPaths();
+
+    // Searches own grid sized arrays, finished ones are kept for the next request
+    std::vector<SlicedPathRequest> SlicedPaths;
+    std::vector<std::unique_ptr<HexTimeSlicedSearch>> IdleSlicedSearches;
+    std::vector<SlicedPathRequest> FinishedSlicedPaths;
+    std::vector<Hex> SlicedPathBuffer;
+    int NextSlicedHandle = 1;
+
+    // Cached flow fields, least recently used one gets rebuilt for a new goal
+    std::vector<HexFlowField> FlowFields;
+    uint32 FlowFieldClock = 0;
 
     std::map<EHexTypes, UMaterialInstance*> Materials;
 
-    std::vector<Hex> SelectedHexes;
+    // Selected tile indices, with a per-tile flag for O(1) membership
+    std::vector<int> SelectedTiles;
+    std::vector<uint8> TileSelected;
+
+    // Scratch of SetSelection, a tile is in the new selection when its mark matches the generation
+    std::vector<int> NextSelectedTiles;
+    std::vector<uint32> SelectionMark;
+    uint32 SelectionGeneration = 0;
+
+    int RenderUpdateCount = 0;
+    int RenderUpdatesLastFrame = 0;
+    uint32 TerrainVersion = 0;
 };
 
 struct PriorityQueue
@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+
+// Maps the axial coordinates of the rectangular grid built by GenerateGrid to a dense index.
+// Columns follow Q, rows follow R shifted by floor(Q / 2), so every index in [0, Num) is a tile.
+struct HexGridLayout
+{
+    HexGridLayout() = default;
+
+    HexGridLayout(const int LeftCount, const int RightCount, const int UpCount, const int DownCount) :
+        Left(LeftCount),
+        Up(UpCount),
+        Width(FMath::Max(RightCount - LeftCount + 1, 0)),
+        Height(FMath::Max(DownCount - UpCount + 1, 0)) {}
+
+    // floor(Q / 2) without going through floats
+    static int QOffset(const int Q)
+    {
+        return Q >= 0 ? Q / 2 : (Q - 1) / 2;
+    }
+
+    int Num() const
+    {
+        return Width * Height;
+    }
+
+    // Returns INDEX_NONE when the hex is outside of the grid
+    int IndexOf(const int Q, const int R) const
+    {
+        const int Column = Q - Left;
+        const int Row = R + QOffset(Q) - Up;
+        if (Column < 0 || Column >= Width || Row < 0 || Row >= Height)
+        {
+            return INDEX_NONE;
+        }
+
+        return Column * Height + Row;
+    }
+
+    int IndexOf(const Hex& H) const
+    {
+        return IndexOf(H.Q, H.R);
+    }
+
+    bool IsValid(const Hex& H) const
+    {
+        return IndexOf(H) != INDEX_NONE;
+    }
+
+    Hex HexAt(const int Index) const
+    {
+        const int Q = Index / Height + Left;
+        const int R = Index % Height + Up - QOffset(Q);
+        return Hex(Q, R);
+    }
+
+    // Returns INDEX_NONE when the neighbor is outside of the grid
+    int NeighborIndex(const int Index, const int Direction) const
+    {
+        const Hex H = HexAt(Index);
+        return IndexOf(H.Q + DirectionQ[Direction], H.R + DirectionR[Direction]);
+    }
+
+    // Direction that steps from one hex onto its neighbor, INDEX_NONE when they aren't adjacent
+    static int DirectionOf(const Hex& From, const Hex& To)
+    {
+        for (int Direction = 0; Direction < 6; Direction++)
+        {
+            if (To.Q - From.Q == DirectionQ[Direction] && To.R - From.R == DirectionR[Direction])
+            {
+                return Direction;
+            }
+        }
+
+        return INDEX_NONE;
+    }
+
+    bool operator==(const HexGridLayout& Other) const
+    {
+        return Left == Other.Left && Up == Other.Up && Width == Other.Width && Height == Other.Height;
+    }
+
+    bool operator!=(const HexGridLayout& Other) const
+    {
+        return !(*this == Other);
+    }
+
+    // Axial offsets in the same order as AHexGridManager::DirectionVectors
+    static constexpr int DirectionQ[6] = { 1, 1, 0, -1, -1, 0 };
+    static constexpr int DirectionR[6] = { 0, -1, -1, 0, 1, 1 };
+
+    int Left = 0;
+    int Up = 0;
+    int Width = 0;
+    int Height = 0;
+};
+
+// Fixed six-slot neighbor list, filled without touching the heap
+struct HexNeighbors
+{
+    HexNeighbors() = default;
+
+    HexNeighbors(const HexGridLayout& Layout, const int Index)
+    {
+        const Hex H = Layout.HexAt(Index);
+        for (int Direction = 0; Direction < 6; Direction++)
+        {
+            const int Neighbor = Layout.IndexOf(H.Q + HexGridLayout::DirectionQ[Direction], H.R + HexGridLayout::DirectionR[Direction]);
+            if (Neighbor != INDEX_NONE)
+            {
+                Indices[Num++] = Neighbor;
+            }
+        }
+    }
+
+    const int* begin() const { return Indices; }
+    const int* end() const { return Indices + Num; }
+
+    int Indices[6];
+    int Num = 0;
+};
+
+// Contiguous per-tile storage indexed directly by axial coordinates
+template <typename T>
+struct HexGridStorage
+{
+    void Init(const HexGridLayout& InLayout, const T& Value = T())
+    {
+        Layout = InLayout;
+        Items.assign(Layout.Num(), Value);
+    }
+
+    bool IsValid(const Hex& H) const
+    {
+        return Layout.IsValid(H);
+    }
+
+    // Returns nullptr when the hex is outside of the grid
+    T* Find(const Hex& H)
+    {
+        const int Index = Layout.IndexOf(H);
+        return Index != INDEX_NONE ? &Items[Index] : nullptr;
+    }
+
+    const T* Find(const Hex& H) const
+    {
+        const int Index = Layout.IndexOf(H);
+        return Index != INDEX_NONE ? &Items[Index] : nullptr;
+    }
+
+    T& operator[](const int Index)
+    {
+        return Items[Index];
+    }
+
+    const T& operator[](const int Index) const
+    {
+        return Items[Index];
+    }
+
+    int Num() const
+    {
+        return static_cast<int>(Items.size());
+    }
+
+    const HexGridLayout& GetLayout() const
+    {
+        return Layout;
+    }
+
+private:
+    HexGridLayout Layout;
+    std::vector<T> Items;
+};
@@ -0,0 +1,284 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexIncrementalPlanner.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include "Hex.h"
+
+namespace
+{
+    constexpr double Infinity = std::numeric_limits<double>::infinity();
+}
+
+void HexIncrementalPlanner::Init(const HexTerrain* InTerrain, const float InMinTileCost)
+{
+    Terrain = InTerrain;
+    MinTileCost = InMinTileCost;
+    Reset();
+}
+
+void HexIncrementalPlanner::Reset()
+{
+    RootIndex = INDEX_NONE;
+    GoalIndex = INDEX_NONE;
+}
+
+bool HexIncrementalPlanner::FindPath(const Hex& Start, const Hex& Goal, std::vector<Hex>& OutPath)
+{
+    OutPath.clear();
+
+    if (!Plan(Start, Goal))
+    {
+        return false;
+    }
+
+    const HexGridLayout& Layout = Terrain->GetLayout();
+    for (auto It = Trail.rbegin(); It != Trail.rend(); ++It)
+    {
+        OutPath.push_back(Layout.HexAt(*It));
+    }
+
+    return true;
+}
+
+bool HexIncrementalPlanner::FindPath(const Hex& Start, const Hex& Goal, HexPath& OutPath)
+{
+    OutPath.Clear();
+
+    if (!Plan(Start, Goal))
+    {
+        return false;
+    }
+
+    // Trail runs from the goal back to the root
+    const HexGridLayout& Layout = Terrain->GetLayout();
+    const int Steps = static_cast<int>(Trail.size()) - 1;
+    OutPath.Init(Start, Goal, Steps);
+    for (int Step = 0; Step < Steps; Step++)
+    {
+        const Hex From = Layout.HexAt(Trail[Steps - Step]);
+        const Hex To = Layout.HexAt(Trail[Steps - Step - 1]);
+        OutPath.SetDirection(Step, HexGridLayout::DirectionOf(From, To));
+    }
+
+    return true;
+}
+
+bool HexIncrementalPlanner::Plan(const Hex& Start, const Hex& Goal)
+{
+    Trail.clear();
+    NodesExpanded = 0;
+
+    if (!Terrain)
+    {
+        return false;
+    }
+
+    const HexGridLayout& Layout = Terrain->GetLayout();
+    const int StartIndex = Layout.IndexOf(Start);
+    const int NewGoalIndex = Layout.IndexOf(Goal);
+    if (StartIndex == INDEX_NONE || NewGoalIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    if (StartIndex != RootIndex || static_cast<int>(G.size()) != Terrain->Num())
+    {
+        Restart(StartIndex, NewGoalIndex);
+    }
+    else if (NewGoalIndex != GoalIndex)
+    {
+        // keys already in the queue stay valid lower bounds thanks to Km
+        Km += Heuristic(NewGoalIndex);
+        GoalIndex = NewGoalIndex;
+    }
+    GoalHex = Goal;
+
+    ComputeShortestPath();
+
+    if (G[GoalIndex] == Infinity)
+    {
+        return false; // no path can be found
+    }
+
+    // Walk back to the root, entering a tile costs the same from every neighbor so the best step is the lowest G
+    int Current = GoalIndex;
+    for (int Steps = 0; Current != RootIndex; Steps++)
+    {
+        if (Steps > Terrain->Num())
+        {
+            Trail.clear();
+            return false;
+        }
+
+        Trail.push_back(Current);
+
+        int Best = INDEX_NONE;
+        for (const int Next : HexNeighbors(Layout, Current))
+        {
+            if (Best == INDEX_NONE || G[Next] < G[Best])
+            {
+                Best = Next;
+            }
+        }
+        Current = Best;
+    }
+
+    Trail.push_back(RootIndex);
+
+    return true;
+}
+
+void HexIncrementalPlanner::OnTileChanged(const int Index)
+{
+    if (RootIndex == INDEX_NONE || Index < 0 || Index >= static_cast<int>(G.size()))
+    {
+        return;
+    }
+
+    // Only the cost of entering this tile changed
+    UpdateVertex(Index);
+}
+
+void HexIncrementalPlanner::Restart(const int InRootIndex, const int InGoalIndex)
+{
+    const int TileCount = Terrain->Num();
+    G.assign(TileCount, Infinity);
+    Rhs.assign(TileCount, Infinity);
+    OpenKey.assign(TileCount, Key{ Infinity, Infinity });
+    InOpen.assign(TileCount, 0);
+    Open.clear();
+
+    RootIndex = InRootIndex;
+    GoalIndex = InGoalIndex;
+    GoalHex = Terrain->GetLayout().HexAt(GoalIndex);
+    Km = 0;
+
+    Rhs[RootIndex] = 0;
+    Insert(RootIndex, CalculateKey(RootIndex));
+}
+
+double HexIncrementalPlanner::Heuristic(const int Index) const
+{
+    return Hex::Distance(Terrain->GetLayout().HexAt(Index), GoalHex) * static_cast<double>(MinTileCost);
+}
+
+HexIncrementalPlanner::Key HexIncrementalPlanner::CalculateKey(const int Index) const
+{
+    const double Cost = FMath::Min(G[Index], Rhs[Index]);
+    return Key{ Cost + Heuristic(Index) + Km, Cost };
+}
+
+void HexIncrementalPlanner::UpdateVertex(const int Index)
+{
+    if (Index != RootIndex)
+    {
+        double Best = Infinity;
+        if (Terrain->IsPassable(Index))
+        {
+            for (const int Next : HexNeighbors(Terrain->GetLayout(), Index))
+            {
+                Best = FMath::Min(Best, G[Next]);
+            }
+            Best += Terrain->GetCost(Index);
+        }
+        Rhs[Index] = Best;
+    }
+
+    InOpen[Index] = 0;
+    if (G[Index] != Rhs[Index])
+    {
+        Insert(Index, CalculateKey(Index));
+    }
+}
+
+void HexIncrementalPlanner::ComputeShortestPath()
+{
+    const HexGridLayout& Layout = Terrain->GetLayout();
+
+    while (true)
+    {
+        const int Current = Top();
+        if (Current == INDEX_NONE)
+        {
+            break;
+        }
+
+        const Key OldKey = OpenKey[Current];
+        if (!(OldKey < CalculateKey(GoalIndex)) && Rhs[GoalIndex] == G[GoalIndex])
+        {
+            break;
+        }
+
+        std::pop_heap(Open.begin(), Open.end(), std::greater<OpenEntry>());
+        Open.pop_back();
+        InOpen[Current] = 0;
+        NodesExpanded++;
+
+        const Key NewKey = CalculateKey(Current);
+        if (OldKey < NewKey)
+        {
+            Insert(Current, NewKey);
+        }
+        else if (G[Current] > Rhs[Current])
+        {
+            G[Current] = Rhs[Current];
+            for (const int Next : HexNeighbors(Layout, Current))
+            {
+                UpdateVertex(Next);
+            }
+        }
+        else
+        {
+            G[Current] = Infinity;
+            UpdateVertex(Current);
+            for (const int Next : HexNeighbors(Layout, Current))
+            {
+                UpdateVertex(Next);
+            }
+        }
+    }
+}
+
+void HexIncrementalPlanner::Insert(const int Index, const Key& K)
+{
+    // Stale entries pile up with lazy removal, rebuild the heap from the open tiles once in a while
+    if (Open.size() > G.size() * 4 + 64)
+    {
+        Open.clear();
+        for (int i = 0; i < static_cast<int>(InOpen.size()); i++)
+        {
+            if (InOpen[i])
+            {
+                Open.push_back(OpenEntry{ OpenKey[i], i });
+            }
+        }
+        std::make_heap(Open.begin(), Open.end(), std::greater<OpenEntry>());
+    }
+
+    InOpen[Index] = 1;
+    OpenKey[Index] = K;
+    Open.push_back(OpenEntry{ K, Index });
+    std::push_heap(Open.begin(), Open.end(), std::greater<OpenEntry>());
+}
+
+int HexIncrementalPlanner::Top()
+{
+    while (!Open.empty())
+    {
+        const OpenEntry& Entry = Open.front();
+        if (InOpen[Entry.Index] && Entry.K == OpenKey[Entry.Index])
+        {
+            return Entry.Index;
+        }
+
+        std::pop_heap(Open.begin(), Open.end(), std::greater<OpenEntry>());
+        Open.pop_back();
+    }
+
+    return INDEX_NONE;
+}
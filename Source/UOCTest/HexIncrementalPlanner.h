@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexPath.h"
+#include "HexTerrain.h"
+
+// D* Lite planner that keeps its search between calls. The search is rooted at the start hex,
+// so moving the goal or changing a tile only repairs the part of the search that is affected.
+// Uses an admissible heuristic, so paths are cost optimal.
+class UOCTEST_API HexIncrementalPlanner
+{
+public:
+    // Attaches to the terrain. MinTileCost scales the hex distance heuristic and must not
+    // be larger than the cheapest passable tile.
+    void Init(const HexTerrain* InTerrain, float InMinTileCost);
+
+    // Drops the search, the next FindPath starts from scratch
+    void Reset();
+
+    // Writes Start..Goal into OutPath, returns false when Goal can't be reached
+    bool FindPath(const Hex& Start, const Hex& Goal, std::vector<Hex>& OutPath);
+    bool FindPath(const Hex& Start, const Hex& Goal, HexPath& OutPath);
+
+    // Call after the type of a tile changed
+    void OnTileChanged(int Index);
+
+    // Number of nodes taken from the open list by the last FindPath
+    int NodesExpanded = 0;
+
+private:
+    struct Key
+    {
+        double K1;
+        double K2;
+
+        bool operator<(const Key& Other) const
+        {
+            return K1 < Other.K1 || (K1 == Other.K1 && K2 < Other.K2);
+        }
+
+        bool operator==(const Key& Other) const
+        {
+            return K1 == Other.K1 && K2 == Other.K2;
+        }
+    };
+
+    struct OpenEntry
+    {
+        Key K;
+        int Index;
+
+        bool operator>(const OpenEntry& Other) const
+        {
+            return Other.K < K;
+        }
+    };
+
+    // Repairs the search and fills Trail with the tiles from Goal back to Start
+    bool Plan(const Hex& Start, const Hex& Goal);
+
+    void Restart(int InRootIndex, int InGoalIndex);
+
+    double Heuristic(int Index) const;
+    Key CalculateKey(int Index) const;
+
+    void UpdateVertex(int Index);
+    void ComputeShortestPath();
+
+    void Insert(int Index, const Key& K);
+
+    // Returns the index of the top entry after dropping stale ones, INDEX_NONE when empty
+    int Top();
+
+    const HexTerrain* Terrain = nullptr;
+    float MinTileCost = 1.f;
+
+    int RootIndex = INDEX_NONE;
+    int GoalIndex = INDEX_NONE;
+    Hex GoalHex;
+    double Km = 0;
+
+    std::vector<double> G;
+    std::vector<double> Rhs;
+
+    // Entries are removed lazily, a heap entry only counts when it matches OpenKey of an open tile
+    std::vector<OpenEntry> Open;
+    std::vector<Key> OpenKey;
+    std::vector<uint8> InOpen;
+
+    // Tiles of the last path, goal first
+    std::vector<int> Trail;
+};
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+
+// Axial coordinates packed into one 64-bit word, Q in the high half and R in the low half.
+// S is always -Q-R, so it isn't stored.
+struct HexKey
+{
+    HexKey() = default;
+
+    explicit HexKey(const Hex& H) :
+        Value(Pack(H.Q, H.R)) {}
+
+    HexKey(const int Q, const int R) :
+        Value(Pack(Q, R)) {}
+
+    static HexKey FromValue(const uint64 InValue)
+    {
+        HexKey Key;
+        Key.Value = InValue;
+        return Key;
+    }
+
+    int GetQ() const { return static_cast<int32>(static_cast<uint32>(Value >> 32)); }
+    int GetR() const { return static_cast<int32>(static_cast<uint32>(Value)); }
+
+    Hex ToHex() const { return Hex(GetQ(), GetR()); }
+
+    // Murmur3 finalizer, neighboring coordinates end up in unrelated buckets
+    uint64 Hash() const
+    {
+        uint64 H = Value;
+        H ^= H >> 33;
+        H *= 0xff51afd7ed558ccdull;
+        H ^= H >> 33;
+        H *= 0xc4ceb9fe1a85ec53ull;
+        H ^= H >> 33;
+        return H;
+    }
+
+    bool operator==(const HexKey Other) const { return Value == Other.Value; }
+    bool operator!=(const HexKey Other) const { return Value != Other.Value; }
+
+    uint64 Value = 0;
+
+private:
+    static uint64 Pack(const int Q, const int R)
+    {
+        return static_cast<uint64>(static_cast<uint32>(Q)) << 32 | static_cast<uint32>(R);
+    }
+};
@@ -0,0 +1,215 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexKey.h"
+
+// Open addressing map from hex coordinates to T for sparse or unbounded worlds. Keys and values
+// live in flat arrays, collisions probe the next slot and removal shifts the following entries back,
+// so there are no tombstones. The coordinate (MIN_int32, MIN_int32) is reserved to mark empty slots.
+template<typename T>
+class HexKeyMap
+{
+public:
+    HexKeyMap() = default;
+
+    explicit HexKeyMap(const int InitialCapacity)
+    {
+        Reserve(InitialCapacity);
+    }
+
+    int Num() const { return Count; }
+    bool IsEmpty() const { return Count == 0; }
+
+    // Makes room for Number entries without growing again
+    void Reserve(const int Number)
+    {
+        int Capacity = 16;
+        while (Capacity * MaxLoadNumerator < Number * MaxLoadDenominator)
+        {
+            Capacity *= 2;
+        }
+
+        if (Capacity > static_cast<int>(Keys.size()))
+        {
+            Rehash(Capacity);
+        }
+    }
+
+    // Drops every entry, the slots keep their memory
+    void Reset()
+    {
+        std::fill(Keys.begin(), Keys.end(), EmptyKey);
+        std::fill(Values.begin(), Values.end(), T());
+        Count = 0;
+    }
+
+    T* Find(const Hex& H) { return Find(HexKey(H)); }
+    const T* Find(const Hex& H) const { return Find(HexKey(H)); }
+
+    T* Find(const HexKey Key)
+    {
+        const int Slot = FindSlot(Key);
+        return Slot != INDEX_NONE ? &Values[Slot] : nullptr;
+    }
+
+    const T* Find(const HexKey Key) const
+    {
+        const int Slot = FindSlot(Key);
+        return Slot != INDEX_NONE ? &Values[Slot] : nullptr;
+    }
+
+    bool Contains(const Hex& H) const { return FindSlot(HexKey(H)) != INDEX_NONE; }
+
+    // Returns the value of Key, default constructed when it wasn't in the map
+    T& FindOrAdd(const Hex& H) { return FindOrAdd(HexKey(H)); }
+
+    T& FindOrAdd(const HexKey Key)
+    {
+        check(Key != EmptyKey);
+
+        if ((Count + 1) * MaxLoadDenominator > static_cast<int>(Keys.size()) * MaxLoadNumerator)
+        {
+            Rehash(Keys.empty() ? 16 : static_cast<int>(Keys.size()) * 2);
+        }
+
+        const int Mask = static_cast<int>(Keys.size()) - 1;
+        for (int Slot = static_cast<int>(Key.Hash()) & Mask; ; Slot = (Slot + 1) & Mask)
+        {
+            if (Keys[Slot] == Key)
+            {
+                return Values[Slot];
+            }
+
+            if (Keys[Slot] == EmptyKey)
+            {
+                Keys[Slot] = Key;
+                Count++;
+                return Values[Slot];
+            }
+        }
+    }
+
+    void Add(const Hex& H, T Value) { FindOrAdd(HexKey(H)) = std::move(Value); }
+
+    // Returns false when the key wasn't in the map
+    bool Remove(const Hex& H) { return Remove(HexKey(H)); }
+
+    bool Remove(const HexKey Key)
+    {
+        int Slot = FindSlot(Key);
+        if (Slot == INDEX_NONE)
+        {
+            return false;
+        }
+
+        // Move later entries of the same probe run into the hole, so lookups never stop early
+        const int Mask = static_cast<int>(Keys.size()) - 1;
+        for (int Next = (Slot + 1) & Mask; Keys[Next] != EmptyKey; Next = (Next + 1) & Mask)
+        {
+            const int Home = static_cast<int>(Keys[Next].Hash()) & Mask;
+            const bool Movable = ((Next - Home) & Mask) >= ((Next - Slot) & Mask);
+            if (Movable)
+            {
+                Keys[Slot] = Keys[Next];
+                Values[Slot] = std::move(Values[Next]);
+                Slot = Next;
+            }
+        }
+
+        Keys[Slot] = EmptyKey;
+        Values[Slot] = T();
+        Count--;
+        return true;
+    }
+
+    // Calls Visitor(const Hex&, T&) for every entry, in no particular order
+    template<typename VisitorType>
+    void ForEach(VisitorType&& Visitor)
+    {
+        for (size_t Slot = 0; Slot < Keys.size(); Slot++)
+        {
+            if (Keys[Slot] != EmptyKey)
+            {
+                Visitor(Keys[Slot].ToHex(), Values[Slot]);
+            }
+        }
+    }
+
+    template<typename VisitorType>
+    void ForEach(VisitorType&& Visitor) const
+    {
+        for (size_t Slot = 0; Slot < Keys.size(); Slot++)
+        {
+            if (Keys[Slot] != EmptyKey)
+            {
+                Visitor(Keys[Slot].ToHex(), Values[Slot]);
+            }
+        }
+    }
+
+private:
+    // Grows once more than 3/4 of the slots are taken
+    static constexpr int MaxLoadNumerator = 3;
+    static constexpr int MaxLoadDenominator = 4;
+
+    static inline const HexKey EmptyKey = HexKey(MIN_int32, MIN_int32);
+
+    int FindSlot(const HexKey Key) const
+    {
+        if (Keys.empty())
+        {
+            return INDEX_NONE;
+        }
+
+        const int Mask = static_cast<int>(Keys.size()) - 1;
+        for (int Slot = static_cast<int>(Key.Hash()) & Mask; ; Slot = (Slot + 1) & Mask)
+        {
+            if (Keys[Slot] == Key)
+            {
+                return Slot;
+            }
+
+            if (Keys[Slot] == EmptyKey)
+            {
+                return INDEX_NONE;
+            }
+        }
+    }
+
+    void Rehash(const int Capacity)
+    {
+        std::vector<HexKey> OldKeys(Capacity, EmptyKey);
+        std::vector<T> OldValues(Capacity);
+        OldKeys.swap(Keys);
+        OldValues.swap(Values);
+
+        const int Mask = Capacity - 1;
+        for (size_t Old = 0; Old < OldKeys.size(); Old++)
+        {
+            if (OldKeys[Old] == EmptyKey)
+            {
+                continue;
+            }
+
+            int Slot = static_cast<int>(OldKeys[Old].Hash()) & Mask;
+            while (Keys[Slot] != EmptyKey)
+            {
+                Slot = (Slot + 1) & Mask;
+            }
+
+            Keys[Slot] = OldKeys[Old];
+            Values[Slot] = std::move(OldValues[Old]);
+        }
+    }
+
+    std::vector<HexKey> Keys;
+    std::vector<T> Values;
+    int Count = 0;
+};
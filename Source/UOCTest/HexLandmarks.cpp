@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexLandmarks.h"
+
+namespace
+{
+    const float Unreachable = TNumericLimits<float>::Max();
+}
+
+void HexLandmarks::Build(const HexTerrain& Terrain, const int Count, HexSearchContext& Context)
+{
+    Dirty = false;
+    LandmarkCount = 0;
+    TileCount = Terrain.Num();
+
+    const int MaxCount = FMath::Max(Count, 0);
+    FromLandmark.assign(static_cast<size_t>(MaxCount) * TileCount, Unreachable);
+    ToLandmark.assign(static_cast<size_t>(MaxCount) * TileCount, Unreachable);
+
+    // Start from the first passable tile, every next landmark is the tile farthest from the chosen ones
+    int Next = INDEX_NONE;
+    for (int Index = 0; Index < TileCount && Next == INDEX_NONE; Index++)
+    {
+        if (Terrain.IsPassable(Index))
+        {
+            Next = Index;
+        }
+    }
+
+    while (Next != INDEX_NONE && LandmarkCount < MaxCount)
+    {
+        float* From = &FromLandmark[static_cast<size_t>(LandmarkCount) * TileCount];
+        float* To = &ToLandmark[static_cast<size_t>(LandmarkCount) * TileCount];
+        Search(Terrain, Next, false, From, Context);
+        Search(Terrain, Next, true, To, Context);
+        LandmarkCount++;
+
+        Next = INDEX_NONE;
+        float Farthest = 0.f;
+        for (int Index = 0; Index < TileCount; Index++)
+        {
+            float Closest = Unreachable;
+            for (int Landmark = 0; Landmark < LandmarkCount; Landmark++)
+            {
+                Closest = FMath::Min(Closest, FromLandmark[static_cast<size_t>(Landmark) * TileCount + Index]);
+            }
+
+            if (Closest < Unreachable && Closest > Farthest)
+            {
+                Farthest = Closest;
+                Next = Index;
+            }
+        }
+    }
+}
+
+float HexLandmarks::Estimate(const int Index, const int Target) const
+{
+    float Best = 0.f;
+    for (int Landmark = 0; Landmark < LandmarkCount; Landmark++)
+    {
+        const size_t Row = static_cast<size_t>(Landmark) * TileCount;
+
+        // d(L, Target) <= d(L, Index) + d(Index, Target)
+        const float FromIndex = FromLandmark[Row + Index];
+        const float FromTarget = FromLandmark[Row + Target];
+        if (FromIndex < Unreachable && FromTarget < Unreachable)
+        {
+            Best = FMath::Max(Best, FromTarget - FromIndex);
+        }
+
+        // d(Index, L) <= d(Index, Target) + d(Target, L)
+        const float ToIndex = ToLandmark[Row + Index];
+        const float ToTarget = ToLandmark[Row + Target];
+        if (ToIndex < Unreachable && ToTarget < Unreachable)
+        {
+            Best = FMath::Max(Best, ToIndex - ToTarget);
+        }
+    }
+
+    return Best;
+}
+
+void HexLandmarks::Search(const HexTerrain& Terrain, const int Source, const bool Reverse, float* OutCosts, HexSearchContext& Context)
+{
+    const HexGridLayout& Layout = Terrain.GetLayout();
+
+    Context.Begin(Terrain.Num());
+    OutCosts[Source] = 0.f;
+    Context.Push(Source, 0.f);
+
+    while (!Context.IsOpenEmpty())
+    {
+        const int Current = Context.Pop();
+        for (const int Next : HexNeighbors(Layout, Current))
+        {
+            if (!Terrain.IsPassable(Next))
+            {
+                continue;
+            }
+
+            // Reverse steps go from Next into Current, so they pay for Current
+            const float NewCost = OutCosts[Current] + Terrain.GetCost(Reverse ? Current : Next);
+            if (NewCost < OutCosts[Next])
+            {
+                OutCosts[Next] = NewCost;
+                Context.Push(Next, NewCost);
+            }
+        }
+    }
+}
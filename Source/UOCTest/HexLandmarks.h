@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "HexPathfinder.h"
+#include "HexTerrain.h"
+
+// Landmark (ALT) lower bounds. Exact costs from and to a few far apart tiles are precomputed,
+// the triangle inequality then bounds the cost between any two tiles.
+class UOCTEST_API HexLandmarks
+{
+public:
+    void Build(const HexTerrain& Terrain, int Count, HexSearchContext& Context);
+
+    // Admissible estimate of the cost from Index to Target
+    float Estimate(int Index, int Target) const;
+
+    bool IsBuilt() const { return LandmarkCount > 0; }
+
+    // Set when a tile changed after the landmarks were built
+    bool Dirty = true;
+
+private:
+    // Dijkstra over the whole grid. Reverse computes the cost from every tile to Source.
+    static void Search(const HexTerrain& Terrain, int Source, bool Reverse, float* OutCosts, HexSearchContext& Context);
+
+    int LandmarkCount = 0;
+    int TileCount = 0;
+
+    // LandmarkCount rows of TileCount costs
+    std::vector<float> FromLandmark;
+    std::vector<float> ToLandmark;
+};
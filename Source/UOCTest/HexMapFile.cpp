@@ -0,0 +1,248 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexMapFile.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "HexRunLength.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+    // Magic, version, left, up, width, height, chunk tiles, chunk count
+    constexpr int64 HeaderBytes = 8 * sizeof(int32);
+
+    // Offset, stored bytes, compression and three bytes of padding
+    constexpr int64 ChunkEntryBytes = sizeof(int64) + sizeof(int32) + 4;
+}
+
+HexMapFile::~HexMapFile()
+{
+    Close();
+}
+
+bool HexMapFile::Save(const FString& Path, const HexTerrain& Terrain, const EHexMapCompression Compression, int64* OutFileBytes)
+{
+    const HexGridLayout& TerrainLayout = Terrain.GetLayout();
+    const int TileCount = TerrainLayout.Num();
+    const int ChunkCount = (TileCount + ChunkTiles - 1) / ChunkTiles;
+
+    TArray<EHexTypes> Types;
+    Types.SetNumUninitialized(TileCount);
+    for (int Index = 0; Index < TileCount; Index++)
+    {
+        Types[Index] = Terrain.GetType(Index);
+    }
+
+    // Encode first, the chunk table needs the stored sizes
+    TArray<TArray<uint8>> Stored;
+    TArray<EHexMapCompression> StoredCompression;
+    Stored.SetNum(ChunkCount);
+    StoredCompression.Init(EHexMapCompression::None, ChunkCount);
+
+    for (int Chunk = 0; Chunk < ChunkCount; Chunk++)
+    {
+        const int First = Chunk * ChunkTiles;
+        const int Count = FMath::Min(ChunkTiles, TileCount - First);
+        const uint8* Raw = reinterpret_cast<const uint8*>(&Types[First]);
+
+        TArray<uint8> Encoded;
+        if (Compression == EHexMapCompression::RLE)
+        {
+            Encoded.SetNumUninitialized(HexRunLength::MaxEncodedBytes(Count));
+            Encoded.SetNum(HexRunLength::Encode(&Types[First], Count, Encoded.GetData()), false);
+        }
+        else if (Compression == EHexMapCompression::LZ4)
+        {
+            int32 EncodedBytes = FCompression::CompressMemoryBound(NAME_LZ4, Count);
+            Encoded.SetNumUninitialized(EncodedBytes);
+            if (FCompression::CompressMemory(NAME_LZ4, Encoded.GetData(), EncodedBytes, Raw, Count))
+            {
+                Encoded.SetNum(EncodedBytes);
+            }
+            else
+            {
+                Encoded.Reset();
+            }
+        }
+
+        if (Encoded.Num() > 0 && Encoded.Num() < Count)
+        {
+            Stored[Chunk] = MoveTemp(Encoded);
+            StoredCompression[Chunk] = Compression;
+        }
+        else
+        {
+            Stored[Chunk] = TArray<uint8>(Raw, Count);
+        }
+    }
+
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+
+    uint32 FileMagic = Magic;
+    uint32 FileVersion = Version;
+    int32 Left = TerrainLayout.Left;
+    int32 Up = TerrainLayout.Up;
+    int32 Width = TerrainLayout.Width;
+    int32 Height = TerrainLayout.Height;
+    int32 Tiles = ChunkTiles;
+    int32 Count = ChunkCount;
+    Writer << FileMagic << FileVersion << Left << Up << Width << Height << Tiles << Count;
+
+    int64 Offset = HeaderBytes + ChunkEntryBytes * ChunkCount;
+    for (int Chunk = 0; Chunk < ChunkCount; Chunk++)
+    {
+        int32 StoredBytes = Stored[Chunk].Num();
+        uint8 ChunkCompression = static_cast<uint8>(StoredCompression[Chunk]);
+        uint8 Padding[3] = {};
+        Writer << Offset << StoredBytes << ChunkCompression;
+        Writer.Serialize(Padding, sizeof(Padding));
+        Offset += StoredBytes;
+    }
+
+    for (TArray<uint8>& Chunk : Stored)
+    {
+        Writer.Serialize(Chunk.GetData(), Chunk.Num());
+    }
+
+    if (OutFileBytes)
+    {
+        *OutFileBytes = Bytes.Num();
+    }
+
+    return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool HexMapFile::Open(const FString& Path)
+{
+    Close();
+
+    MappedFile = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path);
+    if (MappedFile)
+    {
+        MappedRegion = MappedFile->MapRegion(0, MappedFile->GetFileSize());
+    }
+
+    if (MappedRegion)
+    {
+        Data = MappedRegion->GetMappedPtr();
+        Size = MappedRegion->GetMappedSize();
+    }
+    else if (FFileHelper::LoadFileToArray(Loaded, *Path, FILEREAD_Silent))
+    {
+        Data = Loaded.GetData();
+        Size = Loaded.Num();
+    }
+
+    if (!Data || Size < HeaderBytes)
+    {
+        Close();
+        return false;
+    }
+
+    FMemoryReaderView Reader(TArrayView<const uint8>(Data, static_cast<int32>(FMath::Min<int64>(Size, MAX_int32))));
+
+    uint32 FileMagic = 0;
+    uint32 FileVersion = 0;
+    int32 Left = 0, Up = 0, Width = 0, Height = 0, Tiles = 0, Count = 0;
+    Reader << FileMagic << FileVersion << Left << Up << Width << Height << Tiles << Count;
+
+    const int64 TileCount = static_cast<int64>(Width) * Height;
+    if (FileMagic != Magic || FileVersion == 0 || FileVersion > Version || Width < 0 || Height < 0 || TileCount > MAX_int32
+        || Tiles != ChunkTiles || Count != (TileCount + ChunkTiles - 1) / ChunkTiles || Size < HeaderBytes + ChunkEntryBytes * Count)
+    {
+        Close();
+        return false;
+    }
+
+    Layout.Left = Left;
+    Layout.Up = Up;
+    Layout.Width = Width;
+    Layout.Height = Height;
+
+    Chunks.SetNum(Count);
+    for (ChunkEntry& Chunk : Chunks)
+    {
+        uint8 ChunkCompression = 0;
+        uint8 Padding[3];
+        Reader << Chunk.Offset << Chunk.StoredBytes << ChunkCompression;
+        Reader.Serialize(Padding, sizeof(Padding));
+        Chunk.Compression = static_cast<EHexMapCompression>(ChunkCompression);
+
+        if (Chunk.Offset < 0 || Chunk.StoredBytes < 0 || Chunk.Offset + Chunk.StoredBytes > Size || ChunkCompression > static_cast<uint8>(EHexMapCompression::LZ4))
+        {
+            Close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void HexMapFile::Close()
+{
+    // The region has to go before the file it maps
+    delete MappedRegion;
+    MappedRegion = nullptr;
+    delete MappedFile;
+    MappedFile = nullptr;
+
+    Loaded.Empty();
+    Chunks.Reset();
+    Layout = HexGridLayout();
+    Data = nullptr;
+    Size = 0;
+}
+
+bool HexMapFile::ReadTypes(EHexTypes* OutTypes) const
+{
+    const int TileCount = Layout.Num();
+    for (int Chunk = 0; Chunk < Chunks.Num(); Chunk++)
+    {
+        const ChunkEntry& Entry = Chunks[Chunk];
+        const int First = Chunk * ChunkTiles;
+        const int Count = FMath::Min(ChunkTiles, TileCount - First);
+        const uint8* Stored = Data + Entry.Offset;
+
+        bool Decoded = false;
+        switch (Entry.Compression)
+        {
+        case EHexMapCompression::None:
+            Decoded = Entry.StoredBytes == Count;
+            if (Decoded)
+            {
+                FMemory::Memcpy(OutTypes + First, Stored, Count);
+            }
+            break;
+
+        case EHexMapCompression::RLE:
+            Decoded = HexRunLength::Decode(Stored, Entry.StoredBytes, OutTypes + First, Count);
+            break;
+
+        case EHexMapCompression::LZ4:
+            Decoded = FCompression::UncompressMemory(NAME_LZ4, OutTypes + First, Count, Stored, Entry.StoredBytes);
+            break;
+        }
+
+        if (!Decoded)
+        {
+            return false;
+        }
+    }
+
+    // Damaged bytes in raw chunks, don't let them become types this build can't draw
+    for (int Index = 0; Index < TileCount; Index++)
+    {
+        if (static_cast<uint8>(OutTypes[Index]) >= static_cast<uint8>(EHexTypes::MAX))
+        {
+            OutTypes[Index] = EHexTypes::Invalid;
+        }
+    }
+
+    return true;
+}
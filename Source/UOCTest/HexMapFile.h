@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexEnum.h"
+#include "HexGridStorage.h"
+#include "HexTerrain.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Binary map of a fixed grid: a header with the layout, a chunk table, then the tile types of every chunk.
+// Chunks are runs of ChunkTiles tiles in layout index order, each one stored raw, run length encoded or LZ4 compressed.
+// The file is memory mapped and raw chunks are copied out of the mapping as they are, without parsing.
+// Types this build doesn't know are read as Invalid.
+class UOCTEST_API HexMapFile
+{
+public:
+    static constexpr uint32 Magic = 0x4D584548; // "HEXM"
+
+    // Bump for every layout change, older versions stay readable
+    static constexpr uint32 Version = 1;
+
+    static constexpr int ChunkTiles = 64 * 1024;
+
+    HexMapFile() = default;
+    ~HexMapFile();
+
+    HexMapFile(const HexMapFile&) = delete;
+    HexMapFile& operator=(const HexMapFile&) = delete;
+
+    // Chunks that don't shrink with Compression are stored raw. Returns false when the file can't be written.
+    static bool Save(const FString& Path, const HexTerrain& Terrain, EHexMapCompression Compression, int64* OutFileBytes = nullptr);
+
+    // Maps the file, or reads it when the platform can't map files. Returns false for missing, foreign or damaged files.
+    bool Open(const FString& Path);
+
+    void Close();
+
+    bool IsOpen() const { return Data != nullptr; }
+
+    const HexGridLayout& GetLayout() const { return Layout; }
+
+    int64 GetFileBytes() const { return Size; }
+
+    bool IsMapped() const { return MappedRegion != nullptr; }
+
+    // Decodes every chunk into OutTypes, which holds GetLayout().Num() entries. Safe to call from any thread.
+    // Unknown type values load as Invalid, returns false when a chunk is damaged.
+    bool ReadTypes(EHexTypes* OutTypes) const;
+
+private:
+    struct ChunkEntry
+    {
+        int64 Offset = 0;
+        int32 StoredBytes = 0;
+        EHexMapCompression Compression = EHexMapCompression::None;
+    };
+
+    HexGridLayout Layout;
+    TArray<ChunkEntry> Chunks;
+
+    // Whole file, pointing into the mapping or into Loaded
+    const uint8* Data = nullptr;
+    int64 Size = 0;
+
+    IMappedFileHandle* MappedFile = nullptr;
+    IMappedFileRegion* MappedRegion = nullptr;
+    TArray<uint8> Loaded;
+};
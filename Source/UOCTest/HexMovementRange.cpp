@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexMovementRange.h"
+
+#include <algorithm>
+
+void HexMovementRange::Build(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& InStart, const float InBudget)
+{
+    Layout = Terrain.GetLayout();
+    Start = InStart;
+    Budget = InBudget;
+    Tiles.clear();
+
+    if (static_cast<int>(SlotStamp.size()) != Terrain.Num())
+    {
+        Slot.assign(Terrain.Num(), INDEX_NONE);
+        SlotStamp.assign(Terrain.Num(), 0);
+        Generation = 0;
+    }
+
+    Generation++;
+    if (Generation == 0)
+    {
+        std::fill(SlotStamp.begin(), SlotStamp.end(), 0);
+        Generation = 1;
+    }
+
+    const int StartIndex = Layout.IndexOf(Start);
+    if (StartIndex == INDEX_NONE || Budget < 0.f)
+    {
+        return;
+    }
+
+    Context.Begin(Terrain.Num());
+    Context.Reach(StartIndex, 0, INDEX_NONE);
+    Context.Push(StartIndex, 0);
+
+    while (!Context.IsOpenEmpty())
+    {
+        const int Current = Context.Pop();
+
+        // The heap keeps outdated entries, only the first pop of a tile carries its final cost
+        if (SlotStamp[Current] == Generation)
+        {
+            continue;
+        }
+        Context.NodesExpanded++;
+
+        SlotStamp[Current] = Generation;
+        Slot[Current] = static_cast<int>(Tiles.size());
+        Tiles.push_back({ Current, static_cast<float>(Context.GetCost(Current)), Context.GetCameFrom(Current) });
+
+        for (const int Next : HexNeighbors(Layout, Current))
+        {
+            if (!Terrain.IsPassable(Next) || SlotStamp[Next] == Generation)
+            {
+                continue;
+            }
+
+            // Nothing beyond the budget is ever queued, so the search ends with the range
+            const double NewCost = Context.GetCost(Current) + Terrain.GetCost(Next);
+            if (NewCost > Budget)
+            {
+                continue;
+            }
+
+            if (!Context.IsReached(Next) || NewCost < Context.GetCost(Next))
+            {
+                Context.Reach(Next, NewCost, Current);
+                Context.Push(Next, static_cast<float>(NewCost));
+            }
+        }
+    }
+}
+
+const HexReachableTile* HexMovementRange::Find(const Hex& H) const
+{
+    const int Index = Layout.IndexOf(H);
+    if (Index == INDEX_NONE || Index >= static_cast<int>(SlotStamp.size()) || SlotStamp[Index] != Generation)
+    {
+        return nullptr;
+    }
+
+    return &Tiles[Slot[Index]];
+}
+
+bool HexMovementRange::GetPath(const Hex& To, HexPath& OutPath) const
+{
+    OutPath.Clear();
+
+    const HexReachableTile* Tile = Find(To);
+    if (!Tile)
+    {
+        return false;
+    }
+
+    // Count the steps first, so the directions can be written back to front
+    int Steps = 0;
+    for (const HexReachableTile* Current = Tile; Current->From != INDEX_NONE; Current = &Tiles[Slot[Current->From]])
+    {
+        Steps++;
+    }
+
+    OutPath.Init(Start, To, Steps);
+    for (const HexReachableTile* Current = Tile; Current->From != INDEX_NONE; Current = &Tiles[Slot[Current->From]])
+    {
+        OutPath.SetDirection(--Steps, HexGridLayout::DirectionOf(Layout.HexAt(Current->From), Layout.HexAt(Current->Index)));
+    }
+
+    return true;
+}
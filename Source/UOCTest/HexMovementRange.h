@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexPath.h"
+#include "HexPathfinder.h"
+#include "HexTerrain.h"
+
+// Tile within a movement budget, Cost is the cheapest way there and From the tile before it
+struct HexReachableTile
+{
+    int Index;
+    float Cost;
+    int From;
+};
+
+// Every tile a unit can move to from Start without spending more than Budget. Built by a Dijkstra
+// search that stops at the budget, so the work only depends on the size of the range, not the map.
+class UOCTEST_API HexMovementRange
+{
+public:
+    // Context only provides the open list and costs, the range keeps its own arrays
+    void Build(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& InStart, float InBudget);
+
+    // Reachable tiles in order of cost, Start first
+    const std::vector<HexReachableTile>& GetTiles() const { return Tiles; }
+
+    Hex GetHex(const HexReachableTile& Tile) const { return Layout.HexAt(Tile.Index); }
+
+    bool Contains(const Hex& H) const { return Find(H) != nullptr; }
+
+    // Null when the hex is out of range
+    const HexReachableTile* Find(const Hex& H) const;
+
+    // Path from Start to To taken from the stored predecessors, returns false when To is out of range
+    bool GetPath(const Hex& To, HexPath& OutPath) const;
+
+    const Hex& GetStart() const { return Start; }
+    float GetBudget() const { return Budget; }
+
+private:
+    HexGridLayout Layout;
+    Hex Start;
+    float Budget = 0.f;
+
+    std::vector<HexReachableTile> Tiles;
+
+    // Position of a tile in Tiles, only valid when its stamp matches Generation
+    std::vector<int> Slot;
+    std::vector<uint32> SlotStamp;
+    uint32 Generation = 0;
+};
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexPath.h"
+
+void HexPath::Clear()
+{
+    Steps = 0;
+    HasStart = false;
+    Words.clear();
+}
+
+void HexPath::Init(const Hex& InStart, const Hex& InEnd, const int InSteps)
+{
+    Start = InStart;
+    End = InEnd;
+    Steps = InSteps;
+    HasStart = true;
+    Words.assign((Steps + StepsPerWord - 1) / StepsPerWord, 0);
+}
+
+void HexPath::SetDirection(const int Step, const int Direction)
+{
+    const int Shift = Step % StepsPerWord * 3;
+    uint64& Word = Words[Step / StepsPerWord];
+    Word = (Word & ~(uint64(7) << Shift)) | (uint64(Direction & 7) << Shift);
+}
+
+int HexPath::GetDirection(const int Step) const
+{
+    return static_cast<int>(Words[Step / StepsPerWord] >> (Step % StepsPerWord * 3) & 7);
+}
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexGridStorage.h"
+
+// Path stored as its first hex plus one 3-bit step per move, each an index into
+// AHexGridManager::DirectionVectors. Iterating yields the hexes without building a vector.
+class UOCTEST_API HexPath
+{
+public:
+    class Iterator
+    {
+    public:
+        Iterator(const HexPath* InPath, const int InPosition) :
+            Path(InPath), Position(InPosition), Current(InPath->Start) {}
+
+        const Hex& operator*() const { return Current; }
+        const Hex* operator->() const { return &Current; }
+
+        Iterator& operator++()
+        {
+            if (Position < Path->Steps)
+            {
+                const int Direction = Path->GetDirection(Position);
+                Current = Hex(Current.Q + HexGridLayout::DirectionQ[Direction], Current.R + HexGridLayout::DirectionR[Direction]);
+            }
+            Position++;
+            return *this;
+        }
+
+        bool operator==(const Iterator& Other) const { return Position == Other.Position; }
+        bool operator!=(const Iterator& Other) const { return Position != Other.Position; }
+
+    private:
+        const HexPath* Path;
+        int Position;
+        Hex Current;
+    };
+
+    // Empties the path, the packed steps keep their memory
+    void Clear();
+
+    // Starts a path of Steps moves, the directions are filled in with SetDirection
+    void Init(const Hex& InStart, const Hex& InEnd, int InSteps);
+
+    void SetDirection(int Step, int Direction);
+    int GetDirection(int Step) const;
+
+    // Number of hexes, start included
+    int Num() const { return HasStart ? Steps + 1 : 0; }
+    bool IsEmpty() const { return !HasStart; }
+
+    const Hex& GetStart() const { return Start; }
+    const Hex& GetEnd() const { return End; }
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, Num()); }
+
+private:
+    // 21 steps of 3 bits fit into one word
+    static constexpr int StepsPerWord = 21;
+
+    Hex Start;
+    Hex End;
+    int Steps = 0;
+    bool HasStart = false;
+
+    std::vector<uint64> Words;
+};
@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexPathService.h"
+
+#include "HexRegions.h"
+#include "Tasks/Task.h"
+
+HexPathService::~HexPathService()
+{
+    // Workers only hold shared pointers to the request and the snapshot
+    CancelAll();
+}
+
+void HexPathService::Init(const HexTerrain* InTerrain, HexRegions* InRegions)
+{
+    Terrain = InTerrain;
+    Regions = InRegions;
+    SnapshotStale = true;
+}
+
+int HexPathService::RequestPath(const Hex& Start, const Hex& End, const EHexPathPriority Priority, HexPathCallback OnComplete,
+    const uint32 Channel, const HexSearchSettings& Settings)
+{
+    if (Channel != 0)
+    {
+        for (const RequestPtr& Older : Pending)
+        {
+            if (Older->Channel == Channel)
+            {
+                CancelRequest(Older);
+            }
+        }
+    }
+
+    RequestPtr NewRequest = MakeShared<Request, ESPMode::ThreadSafe>();
+    NewRequest->Handle = NextHandle++;
+    NewRequest->Channel = Channel;
+    NewRequest->Start = Start;
+    NewRequest->End = End;
+    NewRequest->Settings = Settings;
+    NewRequest->Priority = Priority;
+    NewRequest->OnComplete = MoveTemp(OnComplete);
+    Pending.push_back(NewRequest);
+
+    if (!Paused)
+    {
+        Launch(NewRequest);
+    }
+
+    return NewRequest->Handle;
+}
+
+void HexPathService::SetPaused(const bool InPaused)
+{
+    Paused = InPaused;
+    if (Paused)
+    {
+        return;
+    }
+
+    for (const RequestPtr& Pended : Pending)
+    {
+        if (!Pended->Launched && !Pended->Cancelled)
+        {
+            Launch(Pended);
+        }
+    }
+}
+
+void HexPathService::Launch(const RequestPtr& NewRequest)
+{
+    NewRequest->Launched = true;
+
+    if (!Terrain || (Regions && !Regions->CanReach(NewRequest->Start, NewRequest->End)))
+    {
+        NewRequest->Done = true;
+        return;
+    }
+
+    if (SnapshotStale || !Snapshot.IsValid())
+    {
+        Snapshot = MakeShared<HexTerrain, ESPMode::ThreadSafe>(*Terrain);
+        SnapshotStale = false;
+    }
+
+    UE::Tasks::ETaskPriority TaskPriority = UE::Tasks::ETaskPriority::Normal;
+    if (NewRequest->Priority == EHexPathPriority::High)
+    {
+        TaskPriority = UE::Tasks::ETaskPriority::High;
+    }
+    else if (NewRequest->Priority == EHexPathPriority::Background)
+    {
+        TaskPriority = UE::Tasks::ETaskPriority::BackgroundNormal;
+    }
+
+    UE::Tasks::Launch(TEXT("HexPathService"), [NewRequest, TerrainSnapshot = Snapshot]()
+    {
+        if (!NewRequest->Cancelled)
+        {
+            // Every worker thread keeps its own scratch arrays
+            static thread_local HexSearchContext WorkerContext;
+            WorkerContext.CancelFlag = &NewRequest->Cancelled;
+            NewRequest->Found = HexPathfinder::FindShortestPath(*TerrainSnapshot, WorkerContext, NewRequest->Start, NewRequest->End, NewRequest->Path, NewRequest->Settings);
+            WorkerContext.CancelFlag = nullptr;
+        }
+
+        NewRequest->Done.store(true, std::memory_order_release);
+    }, TaskPriority);
+}
+
+void HexPathService::Cancel(const int Handle)
+{
+    for (const RequestPtr& Pended : Pending)
+    {
+        if (Pended->Handle == Handle)
+        {
+            CancelRequest(Pended);
+        }
+    }
+}
+
+void HexPathService::CancelAll()
+{
+    for (const RequestPtr& Pended : Pending)
+    {
+        CancelRequest(Pended);
+    }
+}
+
+void HexPathService::CancelRequest(const RequestPtr& Pended)
+{
+    Pended->Cancelled = true;
+
+    // No worker will ever finish it
+    if (!Pended->Launched)
+    {
+        Pended->Done = true;
+    }
+}
+
+void HexPathService::DeliverResults()
+{
+    for (size_t i = 0; i < Pending.size();)
+    {
+        if (!Pending[i]->Done.load(std::memory_order_acquire))
+        {
+            i++;
+            continue;
+        }
+
+        const RequestPtr Finished = Pending[i];
+        Pending.erase(Pending.begin() + i);
+
+        // Callbacks may queue new requests, Finished keeps this one alive meanwhile
+        if (!Finished->Cancelled && Finished->OnComplete)
+        {
+            Finished->OnComplete(Finished->Handle, Finished->Found, Finished->Path);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexPathfinder.h"
+#include "HexTerrain.h"
+
+class HexRegions;
+
+enum class EHexPathPriority : uint8
+{
+    High,
+    Normal,
+    Background,
+};
+
+// Called on the game thread once the request finished, Path is empty when Found is false
+typedef TFunction<void(int Handle, bool Found, const std::vector<Hex>& Path)> HexPathCallback;
+
+// Runs path queries on task graph workers against an immutable copy of the terrain.
+// Results are handed back on the game thread by DeliverResults.
+class UOCTEST_API HexPathService
+{
+public:
+    ~HexPathService();
+
+    // Regions are optional, with them unreachable requests finish without a search
+    void Init(const HexTerrain* InTerrain, HexRegions* InRegions);
+
+    // The next request takes a fresh snapshot of the terrain
+    void OnTerrainChanged() { SnapshotStale = true; }
+
+    // Queues a search and returns its handle. A non zero Channel cancels the older request
+    // of the same channel, e.g. the previous drag target. Landmark heuristics fall back to HexDistance.
+    int RequestPath(const Hex& Start, const Hex& End, EHexPathPriority Priority, HexPathCallback OnComplete,
+        uint32 Channel = 0, const HexSearchSettings& Settings = HexSearchSettings());
+
+    // A cancelled request never calls back
+    void Cancel(int Handle);
+    void CancelAll();
+
+    // Paused requests wait for SetPaused(false) before they are searched, e.g. until the terrain exists
+    void SetPaused(bool InPaused);
+
+    // Game thread only, calls back every finished request
+    void DeliverResults();
+
+    int GetPendingCount() const { return static_cast<int>(Pending.size()); }
+
+private:
+    struct Request
+    {
+        int Handle = 0;
+        uint32 Channel = 0;
+        Hex Start;
+        Hex End;
+        EHexPathPriority Priority = EHexPathPriority::Normal;
+        HexSearchSettings Settings;
+        HexPathCallback OnComplete;
+
+        // Game thread only, set once a worker was asked to run it
+        bool Launched = false;
+
+        std::atomic<bool> Cancelled { false };
+        std::atomic<bool> Done { false };
+
+        // Written by the worker before Done is set
+        bool Found = false;
+        std::vector<Hex> Path;
+    };
+
+    typedef TSharedPtr<Request, ESPMode::ThreadSafe> RequestPtr;
+    typedef TSharedPtr<const HexTerrain, ESPMode::ThreadSafe> TerrainPtr;
+
+    void Launch(const RequestPtr& NewRequest);
+    void CancelRequest(const RequestPtr& Pended);
+
+    const HexTerrain* Terrain = nullptr;
+    HexRegions* Regions = nullptr;
+
+    TerrainPtr Snapshot;
+    bool SnapshotStale = true;
+    bool Paused = false;
+
+    std::vector<RequestPtr> Pending;
+    int NextHandle = 1;
+};
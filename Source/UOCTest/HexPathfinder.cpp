@@ -0,0 +1,270 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexPathfinder.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "Hex.h"
+#include "HexLandmarks.h"
+
+void HexSearchContext::Begin(const int TileCount, const EHexOpenList InOpenList)
+{
+    if (static_cast<int>(ReachedStamp.size()) != TileCount)
+    {
+        CostSoFar.assign(TileCount, 0.0);
+        CameFrom.assign(TileCount, INDEX_NONE);
+        ReachedStamp.assign(TileCount, 0);
+        LineStamp.assign(TileCount, 0);
+        Generation = 0;
+    }
+
+    // stamps are only reset when the generation wraps around
+    Generation++;
+    if (Generation == 0)
+    {
+        std::fill(ReachedStamp.begin(), ReachedStamp.end(), 0);
+        std::fill(LineStamp.begin(), LineStamp.end(), 0);
+        Generation = 1;
+    }
+
+    OpenList = InOpenList;
+    Open.clear();
+    Buckets.Reset();
+    NodesExpanded = 0;
+    LastExpanded = INDEX_NONE;
+}
+
+void HexSearchContext::Push(const int Index, const float Priority, const bool Preferred)
+{
+    if (OpenList == EHexOpenList::Buckets)
+    {
+        Buckets.Push(Index, FMath::RoundToInt(Priority), Preferred);
+        return;
+    }
+
+    Open.emplace_back(Priority, Index);
+    std::push_heap(Open.begin(), Open.end(), std::greater<OpenEntry>());
+}
+
+int HexSearchContext::Pop()
+{
+    if (OpenList == EHexOpenList::Buckets)
+    {
+        return Buckets.Pop();
+    }
+
+    std::pop_heap(Open.begin(), Open.end(), std::greater<OpenEntry>());
+    const int Index = Open.back().second;
+    Open.pop_back();
+    return Index;
+}
+
+bool HexSearchContext::IsOpenEmpty() const
+{
+    return OpenList == EHexOpenList::Buckets ? Buckets.IsEmpty() : Open.empty();
+}
+
+bool HexPathfinder::FindShortestPath(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& Start, const Hex& End, std::vector<Hex>& OutPath,
+    const HexSearchSettings& Settings, const HexLandmarks* Landmarks)
+{
+    OutPath.clear();
+
+    return Search(Terrain, Context, Start, End, Settings, Landmarks) && WritePath(Terrain, Context, Start, End, OutPath);
+}
+
+bool HexPathfinder::FindShortestPath(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& Start, const Hex& End, HexPath& OutPath,
+    const HexSearchSettings& Settings, const HexLandmarks* Landmarks)
+{
+    OutPath.Clear();
+
+    return Search(Terrain, Context, Start, End, Settings, Landmarks) && WritePath(Terrain, Context, Start, End, OutPath);
+}
+
+bool HexPathfinder::WritePath(const HexTerrain& Terrain, const HexSearchContext& Context, const Hex& Start, const Hex& End, std::vector<Hex>& OutPath)
+{
+    OutPath.clear();
+
+    const HexGridLayout& Layout = Terrain.GetLayout();
+    const int StartIndex = Layout.IndexOf(Start);
+    int Current = Layout.IndexOf(End);
+    if (Current == INDEX_NONE || !Context.IsReached(Current))
+    {
+        return false;
+    }
+
+    // Generate path
+    while (Current != StartIndex)
+    {
+        OutPath.push_back(Layout.HexAt(Current));
+        Current = Context.GetCameFrom(Current);
+    }
+
+    OutPath.push_back(Start);
+    std::reverse(OutPath.begin(), OutPath.end());
+
+    return true;
+}
+
+bool HexPathfinder::WritePath(const HexTerrain& Terrain, const HexSearchContext& Context, const Hex& Start, const Hex& End, HexPath& OutPath)
+{
+    OutPath.Clear();
+
+    const HexGridLayout& Layout = Terrain.GetLayout();
+    const int StartIndex = Layout.IndexOf(Start);
+    const int EndIndex = Layout.IndexOf(End);
+    if (EndIndex == INDEX_NONE || !Context.IsReached(EndIndex))
+    {
+        return false;
+    }
+
+    // Count the steps first, so the directions can be written back to front
+    int Steps = 0;
+    for (int Current = EndIndex; Current != StartIndex; Current = Context.GetCameFrom(Current))
+    {
+        Steps++;
+    }
+
+    OutPath.Init(Start, End, Steps);
+    Hex Current = End;
+    for (int Index = EndIndex; Index != StartIndex; )
+    {
+        Index = Context.GetCameFrom(Index);
+        const Hex From = Layout.HexAt(Index);
+        OutPath.SetDirection(--Steps, HexGridLayout::DirectionOf(From, Current));
+        Current = From;
+    }
+
+    return true;
+}
+
+bool HexPathfinder::Search(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& Start, const Hex& End,
+    const HexSearchSettings& Settings, const HexLandmarks* Landmarks)
+{
+    if (!BeginSearch(Terrain, Context, Start, End, Settings))
+    {
+        return false;
+    }
+
+    return ExpandSearch(Terrain, Context, End, Settings, Landmarks, MAX_int32) == EHexSearchState::Found;
+}
+
+// red blob games
+bool HexPathfinder::BeginSearch(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& Start, const Hex& End, const HexSearchSettings& Settings)
+{
+    const HexGridLayout& Layout = Terrain.GetLayout();
+    const int StartIndex = Layout.IndexOf(Start);
+    if (StartIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    Context.Begin(Terrain.Num(), Settings.OpenList);
+
+    // Prefer the straight line, same hexes as GetHexLine without building the vector
+    const int HexDistance = Hex::Distance(Start, End);
+    const double Step = 1.0 / FMath::Max(HexDistance, 1);
+    for (int i = 0; i <= HexDistance; i++)
+    {
+        const int LineIndex = Layout.IndexOf(Hex::Round(Hex::Lerp(Start, End, Step * i)));
+        if (LineIndex != INDEX_NONE)
+        {
+            Context.MarkLine(LineIndex);
+        }
+    }
+
+    Context.Reach(StartIndex, 0, StartIndex);
+    Context.Push(StartIndex, 0);
+
+    return true;
+}
+
+EHexSearchState HexPathfinder::ExpandSearch(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& End,
+    const HexSearchSettings& Settings, const HexLandmarks* Landmarks, const int MaxExpansions)
+{
+    const HexGridLayout& Layout = Terrain.GetLayout();
+    const int EndIndex = Layout.IndexOf(End);
+    const bool IntegerKeys = Settings.OpenList == EHexOpenList::Buckets;
+
+    // Find End Hex
+    for (int Expansions = 0; Expansions < MaxExpansions; Expansions++)
+    {
+        if (Context.IsOpenEmpty())
+        {
+            return EHexSearchState::NotFound; // no path can be found
+        }
+
+        const int Current = Context.Pop();
+        Context.NodesExpanded++;
+        Context.LastExpanded = Current;
+
+        if (Current == EndIndex)
+        {
+            return EHexSearchState::Found;
+        }
+
+        if ((Context.NodesExpanded & 255) == 0 && Context.IsCancelled())
+        {
+            return EHexSearchState::NotFound;
+        }
+
+        for (const int Next : HexNeighbors(Layout, Current))
+        {
+            if (!Terrain.IsPassable(Next))
+            {
+                continue;
+            }
+
+            const float TileCost = Terrain.GetCost(Next);
+            double NewCost = Context.GetCost(Current) + (IntegerKeys ? FMath::RoundToFloat(TileCost) : TileCost);
+
+            // Integer keys can't take the nudge, the bucket queue prefers line entries on ties instead
+            const bool OnLine = Context.IsOnLine(Current);
+            if (OnLine && !IntegerKeys)
+            {
+                NewCost -= 0.0001;
+            }
+
+            if (!Context.IsReached(Next) || NewCost < Context.GetCost(Next))
+            {
+                Context.Reach(Next, NewCost, Current);
+                const double Priority = NewCost + Estimate(Terrain, Next, End, EndIndex, Settings, Landmarks);
+                Context.Push(Next, Priority, OnLine);
+            }
+        }
+    }
+
+    return Context.IsOpenEmpty() ? EHexSearchState::NotFound : EHexSearchState::Running;
+}
+
+double HexPathfinder::Estimate(const HexTerrain& Terrain, const int Index, const Hex& End, const int EndIndex, const HexSearchSettings& Settings, const HexLandmarks* Landmarks)
+{
+    const Hex Current = Terrain.GetLayout().HexAt(Index);
+
+    switch (Settings.Heuristic)
+    {
+    case EHexHeuristic::Manhattan:
+        return Hex::ManhattanDistance(Current, End);
+
+    case EHexHeuristic::HexDistance:
+        return Hex::Distance(Current, End) * static_cast<double>(Terrain.GetMinCost());
+
+    case EHexHeuristic::Weighted:
+        return Hex::Distance(Current, End) * static_cast<double>(Terrain.GetMinCost()) * Settings.Epsilon;
+
+    case EHexHeuristic::Landmarks:
+    {
+        // Both bounds are admissible, the larger one is tighter
+        const double Bound = Hex::Distance(Current, End) * static_cast<double>(Terrain.GetMinCost());
+        if (Landmarks && Landmarks->IsBuilt() && EndIndex != INDEX_NONE)
+        {
+            return FMath::Max(Bound, static_cast<double>(Landmarks->Estimate(Index, EndIndex)));
+        }
+        return Bound;
+    }
+
+    default:
+        return 0;
+    }
+}
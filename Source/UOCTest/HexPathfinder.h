@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexBucketQueue.h"
+#include "HexPath.h"
+#include "HexTerrain.h"
+
+// Open list used by a search
+enum class EHexOpenList : uint8
+{
+    // Binary heap on float priorities
+    BinaryHeap,
+    // Bucket queue on integer priorities, tile costs are rounded to whole numbers
+    Buckets,
+};
+
+// Estimate of the remaining cost used by a search
+enum class EHexHeuristic : uint8
+{
+    // Sum of the cube deltas, twice the hex distance so it can overestimate
+    Manhattan,
+    // Hex distance times the cheapest tile cost, admissible so paths are optimal
+    HexDistance,
+    // HexDistance times Epsilon, paths cost at most Epsilon times the optimum
+    Weighted,
+    // Landmark lower bounds, admissible and usually tighter than HexDistance
+    Landmarks,
+};
+
+// Where a search stands after a call to HexPathfinder::ExpandSearch
+enum class EHexSearchState : uint8
+{
+    Running,
+    Found,
+    NotFound,
+};
+
+struct HexSearchSettings
+{
+    EHexOpenList OpenList = EHexOpenList::BinaryHeap;
+    EHexHeuristic Heuristic = EHexHeuristic::Manhattan;
+
+    // Suboptimality bound of the Weighted heuristic
+    float Epsilon = 1.5f;
+};
+
+class HexLandmarks;
+
+// Per-tile scratch arrays reused between searches. Instead of clearing them, every search
+// bumps Generation and a tile only counts as reached when its stamp matches.
+struct UOCTEST_API HexSearchContext
+{
+    // Starts a new search, the arrays only grow when the grid got bigger
+    void Begin(int TileCount, EHexOpenList InOpenList = EHexOpenList::BinaryHeap);
+
+    bool IsReached(const int Index) const { return ReachedStamp[Index] == Generation; }
+
+    void Reach(const int Index, const double Cost, const int From)
+    {
+        ReachedStamp[Index] = Generation;
+        CostSoFar[Index] = Cost;
+        CameFrom[Index] = From;
+    }
+
+    double GetCost(const int Index) const { return CostSoFar[Index]; }
+    int GetCameFrom(const int Index) const { return CameFrom[Index]; }
+
+    void MarkLine(const int Index) { LineStamp[Index] = Generation; }
+    bool IsOnLine(const int Index) const { return LineStamp[Index] == Generation; }
+
+    // Open list, either a binary min heap kept in a reused vector or a bucket queue.
+    // Preferred entries win ties in the bucket queue and are ignored by the heap.
+    void Push(int Index, float Priority, bool Preferred = false);
+    int Pop();
+    bool IsOpenEmpty() const;
+
+    EHexOpenList GetOpenList() const { return OpenList; }
+
+    // Number of nodes taken from the open list by the last search
+    int NodesExpanded = 0;
+
+    // Node the last search took from the open list most recently
+    int LastExpanded = INDEX_NONE;
+
+    // Searches give up when this gets set from another thread
+    const std::atomic<bool>* CancelFlag = nullptr;
+
+    bool IsCancelled() const { return CancelFlag && CancelFlag->load(std::memory_order_relaxed); }
+
+private:
+    typedef std::pair<float, int> OpenEntry;
+
+    EHexOpenList OpenList = EHexOpenList::BinaryHeap;
+    std::vector<OpenEntry> Open;
+    HexBucketQueue Buckets;
+
+    std::vector<double> CostSoFar;
+    std::vector<int> CameFrom;
+    std::vector<uint32> ReachedStamp;
+    std::vector<uint32> LineStamp;
+
+    uint32 Generation = 0;
+};
+
+struct UOCTEST_API HexPathfinder
+{
+    // A* over the terrain arrays. Writes the path into OutPath and returns false when End can't be reached.
+    // Does not allocate once Context and OutPath have grown to the size of the grid.
+    // Landmarks are only needed by EHexHeuristic::Landmarks.
+    static bool FindShortestPath(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& Start, const Hex& End, std::vector<Hex>& OutPath,
+        const HexSearchSettings& Settings = HexSearchSettings(), const HexLandmarks* Landmarks = nullptr);
+
+    // Same search, the path is written as packed steps
+    static bool FindShortestPath(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& Start, const Hex& End, HexPath& OutPath,
+        const HexSearchSettings& Settings = HexSearchSettings(), const HexLandmarks* Landmarks = nullptr);
+
+    // Runs the search and leaves the tree in Context, returns false when End can't be reached
+    static bool Search(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& Start, const Hex& End,
+        const HexSearchSettings& Settings = HexSearchSettings(), const HexLandmarks* Landmarks = nullptr);
+
+    // Search in steps: BeginSearch seeds Context, every ExpandSearch takes at most MaxExpansions nodes
+    // from the open list. Returns false when Start is outside of the grid.
+    static bool BeginSearch(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& Start, const Hex& End, const HexSearchSettings& Settings);
+    static EHexSearchState ExpandSearch(const HexTerrain& Terrain, HexSearchContext& Context, const Hex& End,
+        const HexSearchSettings& Settings, const HexLandmarks* Landmarks, int MaxExpansions);
+
+    // Walks the tree of a search that reached End, returns false when it didn't
+    static bool WritePath(const HexTerrain& Terrain, const HexSearchContext& Context, const Hex& Start, const Hex& End, std::vector<Hex>& OutPath);
+    static bool WritePath(const HexTerrain& Terrain, const HexSearchContext& Context, const Hex& Start, const Hex& End, HexPath& OutPath);
+
+    // Remaining cost estimate from Index to End
+    static double Estimate(const HexTerrain& Terrain, int Index, const Hex& End, int EndIndex, const HexSearchSettings& Settings, const HexLandmarks* Landmarks);
+};
@@ -0,0 +1,296 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexRegions.h"
+
+#include <algorithm>
+
+void HexRegions::Build(const HexTerrain* InTerrain)
+{
+    Terrain = InTerrain;
+
+    const int TileCount = Terrain->Num();
+    Label.assign(TileCount, INDEX_NONE);
+    Parent.clear();
+    VisitedStamp.assign(TileCount, 0);
+    VisitedBy.assign(TileCount, 0);
+    Stamp = 0;
+
+    // Flood fill every region once
+    std::vector<int>& Queue = Queues[0];
+    for (int Index = 0; Index < TileCount; Index++)
+    {
+        if (Label[Index] != INDEX_NONE || !Terrain->IsPassable(Index))
+        {
+            continue;
+        }
+
+        const int Region = NewRegion();
+        Label[Index] = Region;
+        Queue.clear();
+        Queue.push_back(Index);
+        for (int Head = 0; Head < static_cast<int>(Queue.size()); Head++)
+        {
+            for (const int Next : HexNeighbors(Terrain->GetLayout(), Queue[Head]))
+            {
+                if (Label[Next] == INDEX_NONE && Terrain->IsPassable(Next))
+                {
+                    Label[Next] = Region;
+                    Queue.push_back(Next);
+                }
+            }
+        }
+    }
+}
+
+void HexRegions::OnTileChanged(const int Index)
+{
+    if (!Terrain || Index < 0 || Index >= static_cast<int>(Label.size()))
+    {
+        return;
+    }
+
+    const bool Passable = Terrain->IsPassable(Index);
+    if (Passable && Label[Index] == INDEX_NONE)
+    {
+        Attach(Index);
+    }
+    else if (!Passable && Label[Index] != INDEX_NONE)
+    {
+        Detach(Index);
+    }
+
+    // Every split leaves a dead region behind, start over before Parent grows without bound
+    if (static_cast<int>(Parent.size()) > Terrain->Num() * 2 + 64)
+    {
+        Build(Terrain);
+    }
+}
+
+bool HexRegions::CanReach(const Hex& Start, const Hex& End)
+{
+    if (!Terrain)
+    {
+        return true;
+    }
+
+    const HexGridLayout& Layout = Terrain->GetLayout();
+    const int StartIndex = Layout.IndexOf(Start);
+    const int EndIndex = Layout.IndexOf(End);
+    if (StartIndex == INDEX_NONE || EndIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    if (StartIndex == EndIndex)
+    {
+        return true;
+    }
+
+    const int EndRegion = GetRegion(EndIndex);
+    if (EndRegion == INDEX_NONE)
+    {
+        return false;
+    }
+
+    if (Label[StartIndex] != INDEX_NONE)
+    {
+        return GetRegion(StartIndex) == EndRegion;
+    }
+
+    // Paths may leave a blocked start, so any neighbor in the region will do
+    for (const int Next : HexNeighbors(Layout, StartIndex))
+    {
+        if (GetRegion(Next) == EndRegion)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int HexRegions::GetRegion(const int Index)
+{
+    return Label[Index] != INDEX_NONE ? Find(Label[Index]) : INDEX_NONE;
+}
+
+int HexRegions::Find(int Region)
+{
+    while (Parent[Region] != Region)
+    {
+        Parent[Region] = Parent[Parent[Region]];
+        Region = Parent[Region];
+    }
+
+    return Region;
+}
+
+int HexRegions::NewRegion()
+{
+    const int Region = static_cast<int>(Parent.size());
+    Parent.push_back(Region);
+    return Region;
+}
+
+void HexRegions::Attach(const int Index)
+{
+    int Root = INDEX_NONE;
+    for (const int Next : HexNeighbors(Terrain->GetLayout(), Index))
+    {
+        if (Label[Next] == INDEX_NONE)
+        {
+            continue;
+        }
+
+        const int Other = Find(Label[Next]);
+        if (Root == INDEX_NONE)
+        {
+            Root = Other;
+        }
+        else if (Other != Root)
+        {
+            Parent[Other] = Root;
+        }
+    }
+
+    Label[Index] = Root != INDEX_NONE ? Root : NewRegion();
+}
+
+void HexRegions::Detach(const int Index)
+{
+    Label[Index] = INDEX_NONE;
+
+    // Walk the ring of neighbors, every run of labeled tiles is already connected through itself
+    const HexGridLayout& Layout = Terrain->GetLayout();
+    int Ring[6];
+    for (int Direction = 0; Direction < 6; Direction++)
+    {
+        const int Next = Layout.NeighborIndex(Index, Direction);
+        Ring[Direction] = Next != INDEX_NONE && Label[Next] != INDEX_NONE ? Next : INDEX_NONE;
+    }
+
+    int Seeds[3];
+    int SeedCount = 0;
+    for (int Direction = 0; Direction < 6; Direction++)
+    {
+        const bool RunStarts = Ring[Direction] != INDEX_NONE && Ring[(Direction + 5) % 6] == INDEX_NONE;
+        if (RunStarts && SeedCount < 3)
+        {
+            Seeds[SeedCount++] = Ring[Direction];
+        }
+    }
+
+    if (SeedCount > 1)
+    {
+        Split(Seeds, SeedCount);
+    }
+}
+
+void HexRegions::Split(const int* Seeds, const int SeedCount)
+{
+    Stamp++;
+    if (Stamp == 0)
+    {
+        std::fill(VisitedStamp.begin(), VisitedStamp.end(), 0);
+        Stamp = 1;
+    }
+
+    // Group of every search, searches that meet join the same group
+    int Group[3] = { 0, 1, 2 };
+    bool Resolved[3] = { false, false, false };
+    int Heads[3] = { 0, 0, 0 };
+    auto FindGroup = [&Group](int Search)
+    {
+        while (Group[Search] != Search)
+        {
+            Search = Group[Search];
+        }
+        return Search;
+    };
+
+    for (int Search = 0; Search < SeedCount; Search++)
+    {
+        Queues[Search].clear();
+        Queues[Search].push_back(Seeds[Search]);
+        VisitedStamp[Seeds[Search]] = Stamp;
+        VisitedBy[Seeds[Search]] = static_cast<uint8>(Search);
+    }
+
+    int OpenGroups = SeedCount;
+    while (OpenGroups > 1)
+    {
+        // One step of every search per round, so the smallest side finishes first
+        for (int Search = 0; Search < SeedCount; Search++)
+        {
+            std::vector<int>& Queue = Queues[Search];
+            if (Heads[Search] >= static_cast<int>(Queue.size()) || Resolved[FindGroup(Search)])
+            {
+                continue;
+            }
+
+            const int Current = Queue[Heads[Search]++];
+            for (const int Next : HexNeighbors(Terrain->GetLayout(), Current))
+            {
+                if (Label[Next] == INDEX_NONE)
+                {
+                    continue;
+                }
+
+                if (VisitedStamp[Next] != Stamp)
+                {
+                    VisitedStamp[Next] = Stamp;
+                    VisitedBy[Next] = static_cast<uint8>(Search);
+                    Queue.push_back(Next);
+                    continue;
+                }
+
+                const int Mine = FindGroup(Search);
+                const int Theirs = FindGroup(VisitedBy[Next]);
+                if (Mine != Theirs)
+                {
+                    Group[Theirs] = Mine;
+                    OpenGroups--;
+                }
+            }
+        }
+
+        // A group with no work left is a region of its own
+        for (int Root = 0; Root < SeedCount && OpenGroups > 1; Root++)
+        {
+            if (FindGroup(Root) != Root || Resolved[Root])
+            {
+                continue;
+            }
+
+            bool Finished = true;
+            for (int Search = 0; Search < SeedCount; Search++)
+            {
+                if (FindGroup(Search) == Root && Heads[Search] < static_cast<int>(Queues[Search].size()))
+                {
+                    Finished = false;
+                }
+            }
+
+            if (!Finished)
+            {
+                continue;
+            }
+
+            const int Region = NewRegion();
+            for (int Search = 0; Search < SeedCount; Search++)
+            {
+                if (FindGroup(Search) == Root)
+                {
+                    for (const int Tile : Queues[Search])
+                    {
+                        Label[Tile] = Region;
+                    }
+                }
+            }
+
+            Resolved[Root] = true;
+            OpenGroups--;
+        }
+    }
+}
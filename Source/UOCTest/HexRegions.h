@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexTerrain.h"
+
+// Connected regions of passable tiles, so queries between regions fail without searching.
+// Merges are union-find unions, a split is found by searching from the separated sides of the
+// changed tile at the same time and relabeling only the side that runs out of tiles first.
+class UOCTEST_API HexRegions
+{
+public:
+    void Build(const HexTerrain* InTerrain);
+
+    // Call after the type of a tile changed
+    void OnTileChanged(int Index);
+
+    // False when no path from Start can reach End, answered without a search
+    bool CanReach(const Hex& Start, const Hex& End);
+
+    // Region of a passable tile, INDEX_NONE for the others
+    int GetRegion(int Index);
+
+private:
+    int Find(int Region);
+    int NewRegion();
+
+    void Attach(int Index);
+    void Detach(int Index);
+
+    // Searches from up to three seeds, relabels every side that turns out to be cut off
+    void Split(const int* Seeds, int SeedCount);
+
+    const HexTerrain* Terrain = nullptr;
+
+    // Raw region of every tile, the actual region is Find(Label)
+    std::vector<int> Label;
+    std::vector<int> Parent;
+
+    // Scratch for Split
+    std::vector<uint32> VisitedStamp;
+    std::vector<uint8> VisitedBy;
+    std::vector<int> Queues[3];
+    uint32 Stamp = 0;
+};
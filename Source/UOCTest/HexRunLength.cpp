@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexRunLength.h"
+
+int HexRunLength::Encode(const EHexTypes* Types, const int Count, uint8* OutBytes)
+{
+    int Written = 0;
+    for (int i = 0; i < Count; )
+    {
+        int Run = 1;
+        while (i + Run < Count && Types[i + Run] == Types[i] && Run < 255)
+        {
+            Run++;
+        }
+
+        OutBytes[Written++] = static_cast<uint8>(Run);
+        OutBytes[Written++] = static_cast<uint8>(Types[i]);
+        i += Run;
+    }
+
+    return Written;
+}
+
+bool HexRunLength::Decode(const uint8* Bytes, const int64 ByteCount, EHexTypes* OutTypes, const int Count)
+{
+    if (ByteCount % 2 != 0)
+    {
+        return false;
+    }
+
+    int Out = 0;
+    for (int64 i = 0; i < ByteCount; i += 2)
+    {
+        if (Out + Bytes[i] > Count)
+        {
+            return false;
+        }
+
+        for (int Run = 0; Run < Bytes[i]; Run++)
+        {
+            OutTypes[Out++] = static_cast<EHexTypes>(Bytes[i + 1]);
+        }
+    }
+
+    return Out == Count;
+}
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexEnum.h"
+
+// Tile types as (count, type) byte pairs, one pair per run of up to 255 tiles of one type.
+// Map files, evicted streamed chunks and replicated terrain chunks all store this format.
+struct UOCTEST_API HexRunLength
+{
+    // Size OutBytes of Encode needs, reached when no two neighboring tiles share a type
+    static int MaxEncodedBytes(const int Count) { return Count * 2; }
+
+    // Writes the runs of Count types into OutBytes and returns the bytes written
+    static int Encode(const EHexTypes* Types, int Count, uint8* OutBytes);
+
+    // Returns false when the runs don't hold exactly Count tiles. Type bytes are copied as stored,
+    // callers decide what happens to values past EHexTypes::MAX.
+    static bool Decode(const uint8* Bytes, int64 ByteCount, EHexTypes* OutTypes, int Count);
+};
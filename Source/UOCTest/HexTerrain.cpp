@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexTerrain.h"
+
+void HexTerrain::Init(const HexGridLayout& InLayout, const EHexTypes Type, const float Cost, const float InMinCost)
+{
+    Layout = InLayout;
+    MinCost = InMinCost;
+
+    const int Count = Layout.Num();
+    Types.assign(Count, Type);
+    Costs.assign(Count, Cost);
+    Flags.assign(Count, IsPassableType(Type) ? HexTileFlag_Passable : HexTileFlag_None);
+}
+
+void HexTerrain::SetTile(const int Index, const EHexTypes Type, const float Cost)
+{
+    Types[Index] = Type;
+    Costs[Index] = Cost;
+    Flags[Index] = IsPassableType(Type) ? HexTileFlag_Passable : HexTileFlag_None;
+}
+
+bool HexTerrain::IsPassableType(const EHexTypes Type)
+{
+    return Type != EHexTypes::Invalid && Type != EHexTypes::Blocked && Type < EHexTypes::MAX;
+}
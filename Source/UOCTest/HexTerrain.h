@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "HexEnum.h"
+#include "HexGridStorage.h"
+
+// Per-tile bit flags stored next to the terrain type
+enum EHexTileFlags : uint8
+{
+    HexTileFlag_None = 0,
+    HexTileFlag_Passable = 1 << 0,
+};
+
+// Authoritative terrain state of the grid, kept as packed per-tile arrays so
+// pathfinding never has to reach into the AHexTile actors.
+struct UOCTEST_API HexTerrain
+{
+    // MinCost is the cheapest cost a passable tile can have, heuristics scale by it
+    void Init(const HexGridLayout& InLayout, EHexTypes Type, float Cost, float InMinCost);
+
+    // Writes type, movement cost and derived flags of a single tile
+    void SetTile(int Index, EHexTypes Type, float Cost);
+
+    static bool IsPassableType(EHexTypes Type);
+
+    EHexTypes GetType(const int Index) const { return Types[Index]; }
+    float GetCost(const int Index) const { return Costs[Index]; }
+    uint8 GetFlags(const int Index) const { return Flags[Index]; }
+    bool IsPassable(const int Index) const { return (Flags[Index] & HexTileFlag_Passable) != 0; }
+
+    float GetMinCost() const { return MinCost; }
+
+    int Num() const { return Layout.Num(); }
+    const HexGridLayout& GetLayout() const { return Layout; }
+
+private:
+    HexGridLayout Layout;
+    float MinCost = 1.f;
+
+    std::vector<EHexTypes> Types;
+    std::vector<float> Costs;
+    std::vector<uint8> Flags;
+};
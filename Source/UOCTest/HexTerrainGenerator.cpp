@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexTerrainGenerator.h"
+
+#include "Async/ParallelFor.h"
+#include "Math/VectorRegister.h"
+
+namespace
+{
+    // Below this many tiles a map is generated on the calling thread, a streamed chunk isn't worth the task overhead
+    constexpr int ParallelThreshold = 4096;
+
+    // 24 bits of a lattice hash scaled to [0, 1)
+    constexpr float HashToUnit = 1.f / 16777216.f;
+
+    // Integer hash of four lattice points, wraps like uint32 arithmetic
+    VectorRegister4Int HashLattice(const VectorRegister4Int& X, const VectorRegister4Int& Y, const VectorRegister4Int& Seed)
+    {
+        VectorRegister4Int H = VectorIntAdd(VectorIntMultiply(X, VectorIntSet1(0x27d4eb2d)), VectorIntMultiply(Y, VectorIntSet1(0x165667b1)));
+        H = VectorIntXor(H, Seed);
+        H = VectorIntXor(H, VectorShiftRightImmLogical(H, 13));
+        H = VectorIntMultiply(H, VectorIntSet1(0x5bd1e995));
+        return VectorIntXor(H, VectorShiftRightImmLogical(H, 15));
+    }
+
+    VectorRegister4Float LatticeValue(const VectorRegister4Int& X, const VectorRegister4Int& Y, const VectorRegister4Int& Seed)
+    {
+        const VectorRegister4Int Bits = VectorIntAnd(HashLattice(X, Y, Seed), VectorIntSet1(0xFFFFFF));
+        return VectorMultiply(VectorIntToFloat(Bits), VectorSetFloat1(HashToUnit));
+    }
+
+    VectorRegister4Float Lerp(const VectorRegister4Float& A, const VectorRegister4Float& B, const VectorRegister4Float& T)
+    {
+        return VectorAdd(A, VectorMultiply(VectorSubtract(B, A), T));
+    }
+
+    // Value noise in [0, 1) at four points given in lattice units.
+    // Multiply and add stay separate, a fused multiply-add would round differently on some targets.
+    VectorRegister4Float ValueNoise(const VectorRegister4Float& X, const VectorRegister4Float& Y, const VectorRegister4Int& Seed)
+    {
+        const VectorRegister4Float FloorX = VectorFloor(X);
+        const VectorRegister4Float FloorY = VectorFloor(Y);
+        const VectorRegister4Int X0 = VectorFloatToInt(FloorX);
+        const VectorRegister4Int Y0 = VectorFloatToInt(FloorY);
+        const VectorRegister4Int X1 = VectorIntAdd(X0, VectorIntSet1(1));
+        const VectorRegister4Int Y1 = VectorIntAdd(Y0, VectorIntSet1(1));
+
+        // Smoothstep weights
+        const VectorRegister4Float FracX = VectorSubtract(X, FloorX);
+        const VectorRegister4Float FracY = VectorSubtract(Y, FloorY);
+        const VectorRegister4Float Three = VectorSetFloat1(3.f);
+        const VectorRegister4Float Two = VectorSetFloat1(2.f);
+        const VectorRegister4Float TX = VectorMultiply(VectorMultiply(FracX, FracX), VectorSubtract(Three, VectorMultiply(Two, FracX)));
+        const VectorRegister4Float TY = VectorMultiply(VectorMultiply(FracY, FracY), VectorSubtract(Three, VectorMultiply(Two, FracY)));
+
+        const VectorRegister4Float Bottom = Lerp(LatticeValue(X0, Y0, Seed), LatticeValue(X1, Y0, Seed), TX);
+        const VectorRegister4Float Top = Lerp(LatticeValue(X0, Y1, Seed), LatticeValue(X1, Y1, Seed), TX);
+        return Lerp(Bottom, Top, TY);
+    }
+}
+
+void HexTerrainGenerator::Init(const HexTerrainGeneratorSettings& InSettings, const float InHorizontalSpacing, const float InVerticalSpacing)
+{
+    Settings = InSettings;
+    Settings.FeatureSize = FMath::Max(Settings.FeatureSize, 1.f);
+    Settings.Octaves = FMath::Clamp(Settings.Octaves, 1, 16);
+    HorizontalSpacing = InHorizontalSpacing;
+    VerticalSpacing = InVerticalSpacing;
+}
+
+void HexTerrainGenerator::Generate(const HexGridLayout& Layout, EHexTypes* OutTypes) const
+{
+    const EParallelForFlags Flags = Layout.Num() < ParallelThreshold ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+
+    ParallelFor(Layout.Width, [this, &Layout, OutTypes](const int32 Column)
+    {
+        const int Q = Layout.Left + Column;
+        const int FirstR = Layout.Up - HexGridLayout::QOffset(Q);
+        EHexTypes* ColumnTypes = OutTypes + Column * Layout.Height;
+
+        // The last group may run past the column, its extra lanes are computed and dropped
+        alignas(16) float Values[4];
+        for (int Row = 0; Row < Layout.Height; Row += 4)
+        {
+            VectorStoreAligned(SampleRows(Q, FirstR + Row), Values);
+
+            const int Count = FMath::Min(4, Layout.Height - Row);
+            for (int Lane = 0; Lane < Count; Lane++)
+            {
+                ColumnTypes[Row + Lane] = Classify(Values[Lane]);
+            }
+        }
+    }, Flags);
+}
+
+float HexTerrainGenerator::Sample(const Hex& H) const
+{
+    alignas(16) float Values[4];
+    VectorStoreAligned(SampleRows(H.Q, H.R), Values);
+    return Values[0];
+}
+
+VectorRegister4Float HexTerrainGenerator::SampleRows(const int Q, const int R) const
+{
+    // Same placement as AHexGridManager::HexToWorldPoint, X is up and Y is right
+    const VectorRegister4Float Rows = VectorIntToFloat(VectorIntAdd(VectorIntSet1(R), MakeVectorRegisterInt(0, 1, 2, 3)));
+    const VectorRegister4Float WorldX = VectorAdd(VectorSetFloat1(VerticalSpacing * Q), VectorMultiply(VectorMultiply(Rows, VectorSetFloat1(VerticalSpacing)), VectorSetFloat1(2.f)));
+    const VectorRegister4Float WorldY = VectorSetFloat1(Q * HorizontalSpacing);
+
+    VectorRegister4Float Sum = VectorZeroFloat();
+    float Frequency = 1.f / Settings.FeatureSize;
+    float Amplitude = 1.f;
+    float TotalAmplitude = 0.f;
+
+    for (int Octave = 0; Octave < Settings.Octaves; Octave++)
+    {
+        // Every octave gets its own lattice values, unsigned so the wrap is defined
+        const int32 OctaveSeed = static_cast<int32>(static_cast<uint32>(Settings.Seed) + static_cast<uint32>(Octave) * 0x9E3779B9u);
+        const VectorRegister4Float Scale = VectorSetFloat1(Frequency);
+        const VectorRegister4Float Noise = ValueNoise(VectorMultiply(WorldX, Scale), VectorMultiply(WorldY, Scale), VectorIntSet1(OctaveSeed));
+
+        Sum = VectorAdd(Sum, VectorMultiply(Noise, VectorSetFloat1(Amplitude)));
+        TotalAmplitude += Amplitude;
+        Frequency *= 2.f;
+        Amplitude *= 0.5f;
+    }
+
+    return VectorMultiply(Sum, VectorSetFloat1(1.f / TotalAmplitude));
+}
+
+EHexTypes HexTerrainGenerator::Classify(const float Value) const
+{
+    if (Value < Settings.WaterLevel)
+    {
+        return EHexTypes::Water;
+    }
+
+    if (Value < Settings.DirtLevel)
+    {
+        return EHexTypes::Dirt;
+    }
+
+    return Value < Settings.BlockedLevel ? EHexTypes::Grass : EHexTypes::Blocked;
+}
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexEnum.h"
+#include "HexGridStorage.h"
+
+struct HexTerrainGeneratorSettings
+{
+    int32 Seed = 0;
+
+    // World units between two lattice points of the first octave
+    float FeatureSize = 3000.f;
+
+    int Octaves = 4;
+
+    // Noise is in [0, 1). Below WaterLevel is Water, below DirtLevel Dirt, from BlockedLevel up Blocked, Grass between.
+    float WaterLevel = 0.38f;
+    float DirtLevel = 0.44f;
+    float BlockedLevel = 0.66f;
+};
+
+// Fractal value noise sampled at the hex centers of AHexGridManager::HexToWorldPoint and classified into tile types.
+// Noise only depends on the seed and the world position, so separately generated chunks line up and
+// every run with the same settings makes the same map.
+class UOCTEST_API HexTerrainGenerator
+{
+public:
+    void Init(const HexTerrainGeneratorSettings& InSettings, float InHorizontalSpacing, float InVerticalSpacing);
+
+    // Types of every tile of Layout in index order. Columns are split across worker threads,
+    // rows of a column go four at a time through vector registers.
+    void Generate(const HexGridLayout& Layout, EHexTypes* OutTypes) const;
+
+    // Noise at a single tile, for debugging and tools
+    float Sample(const Hex& H) const;
+
+private:
+    // Noise of four rows of column Q starting at R
+    VectorRegister4Float SampleRows(int Q, int R) const;
+
+    EHexTypes Classify(float Value) const;
+
+    HexTerrainGeneratorSettings Settings;
+    float HorizontalSpacing = 0.f;
+    float VerticalSpacing = 0.f;
+};
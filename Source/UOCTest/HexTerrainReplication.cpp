@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexTerrainReplication.h"
+
+#include "HexGridManager.h"
+#include "HexRunLength.h"
+
+HexGridLayout FHexReplicatedLayout::ToLayout() const
+{
+    HexGridLayout Layout;
+    Layout.Left = Left;
+    Layout.Up = Up;
+    Layout.Width = FMath::Max(Width, 0);
+    Layout.Height = FMath::Max(Height, 0);
+    return Layout;
+}
+
+void FHexReplicatedLayout::FromLayout(const HexGridLayout& Layout)
+{
+    Left = Layout.Left;
+    Up = Layout.Up;
+    Width = Layout.Width;
+    Height = Layout.Height;
+}
+
+void FHexTerrainChunk::PostReplicatedAdd(const FHexTerrainChunkArray& Serializer)
+{
+    if (Serializer.Owner)
+    {
+        Serializer.Owner->OnTerrainChunkReplicated(*this);
+    }
+}
+
+void FHexTerrainChunk::PostReplicatedChange(const FHexTerrainChunkArray& Serializer)
+{
+    if (Serializer.Owner)
+    {
+        Serializer.Owner->OnTerrainChunkReplicated(*this);
+    }
+}
+
+void FHexTerrainChunkArray::Encode(const EHexTypes* Types, const int Count, TArray<uint8>& OutRuns)
+{
+    OutRuns.SetNumUninitialized(HexRunLength::MaxEncodedBytes(Count), false);
+    OutRuns.SetNum(HexRunLength::Encode(Types, Count, OutRuns.GetData()), false);
+}
+
+bool FHexTerrainChunkArray::Decode(const TArray<uint8>& Runs, EHexTypes* OutTypes, const int Count)
+{
+    if (!HexRunLength::Decode(Runs.GetData(), Runs.Num(), OutTypes, Count))
+    {
+        return false;
+    }
+
+    // A type this build doesn't know has no cost or material
+    for (int Index = 0; Index < Count; Index++)
+    {
+        if (OutTypes[Index] >= EHexTypes::MAX)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int64 FHexTerrainChunkArray::GetEncodedBytes() const
+{
+    int64 Bytes = 0;
+    for (const FHexTerrainChunk& Item : Items)
+    {
+        Bytes += Item.Runs.Num();
+    }
+
+    return Bytes;
+}
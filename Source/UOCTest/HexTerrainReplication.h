@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexEnum.h"
+#include "HexGridStorage.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "HexTerrainReplication.generated.h"
+
+class AHexGridManager;
+
+// Bounds of the replicated grid, clients build their grid once it arrives
+USTRUCT()
+struct FHexReplicatedLayout
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Left = 0;
+
+    UPROPERTY()
+    int32 Up = 0;
+
+    UPROPERTY()
+    int32 Width = 0;
+
+    UPROPERTY()
+    int32 Height = 0;
+
+    HexGridLayout ToLayout() const;
+    void FromLayout(const HexGridLayout& Layout);
+};
+
+// Tile types of ChunkTiles consecutive tiles in layout order as (count, type) byte pairs
+USTRUCT()
+struct FHexTerrainChunk : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Chunk = 0;
+
+    UPROPERTY()
+    TArray<uint8> Runs;
+
+    void PostReplicatedAdd(const struct FHexTerrainChunkArray& Serializer);
+    void PostReplicatedChange(const struct FHexTerrainChunkArray& Serializer);
+};
+
+// Whole terrain of a grid. A joining client receives every chunk, after that only the chunks
+// an edit touched are sent again.
+USTRUCT()
+struct FHexTerrainChunkArray : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    // Small enough that a single edit resends little, encoded chunks never exceed 1 KB
+    static constexpr int ChunkTiles = 512;
+
+    UPROPERTY()
+    TArray<FHexTerrainChunk> Items;
+
+    // Receives the chunks on clients, not replicated
+    AHexGridManager* Owner = nullptr;
+
+    static int ChunkCount(const HexGridLayout& Layout) { return (Layout.Num() + ChunkTiles - 1) / ChunkTiles; }
+
+    // HexRunLength runs of Count types
+    static void Encode(const EHexTypes* Types, int Count, TArray<uint8>& OutRuns);
+
+    // Returns false when Runs doesn't hold exactly Count tiles or names a type this build doesn't know
+    static bool Decode(const TArray<uint8>& Runs, EHexTypes* OutTypes, int Count);
+
+    // Bytes of every encoded chunk, what a joining client receives before packet overhead
+    int64 GetEncodedBytes() const;
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FHexTerrainChunk, FHexTerrainChunkArray>(Items, DeltaParms, *this);
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FHexTerrainChunkArray> : public TStructOpsTypeTraitsBase2<FHexTerrainChunkArray>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
@@ -16,7 +16,8 @@ public:
 	// Sets default values for this actor's properties
 	AHexTile();
 
-	UPROPERTY(EditAnywhere)
+	// Mirror of the grid terrain, AHexGridManager owns the authoritative type
+	UPROPERTY(VisibleAnywhere)
 	EHexTypes TileType;
 	
 	// Called every frame
@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HexTimeSlicedSearch.h"
+
+#include "Hex.h"
+
+namespace
+{
+    // Expansions between two looks at the clock
+    constexpr int ExpansionsPerClockCheck = 32;
+}
+
+void HexTimeSlicedSearch::Start(const HexTerrain* InTerrain, const Hex& InStart, const Hex& InEnd,
+    const HexSearchSettings& InSettings, const HexLandmarks* InLandmarks)
+{
+    Terrain = InTerrain;
+    StartHex = InStart;
+    EndHex = InEnd;
+    Settings = InSettings;
+    Landmarks = InLandmarks;
+
+    Restart();
+}
+
+void HexTimeSlicedSearch::Restart()
+{
+    StartDistance = Hex::Distance(StartHex, EndHex);
+    BestDistance = StartDistance;
+
+    const bool Started = Terrain && HexPathfinder::BeginSearch(*Terrain, Context, StartHex, EndHex, Settings);
+    State = Started ? EHexSearchState::Running : EHexSearchState::NotFound;
+}
+
+EHexSearchState HexTimeSlicedSearch::Step(const int MaxExpansions, const double MaxMicroseconds)
+{
+    if (State != EHexSearchState::Running)
+    {
+        return State;
+    }
+
+    const double Deadline = MaxMicroseconds > 0 ? FPlatformTime::Seconds() + MaxMicroseconds * 1e-6 : 0;
+    int Remaining = MaxExpansions;
+    while (Remaining > 0 && State == EHexSearchState::Running)
+    {
+        const int Expansions = Deadline > 0 ? FMath::Min(Remaining, ExpansionsPerClockCheck) : Remaining;
+        const int Before = Context.NodesExpanded;
+        State = HexPathfinder::ExpandSearch(*Terrain, Context, EndHex, Settings, Landmarks, Expansions);
+        Remaining -= Expansions;
+
+        // Only the last expanded node is checked, close enough for a progress estimate
+        if (Context.NodesExpanded != Before)
+        {
+            const Hex Last = Terrain->GetLayout().HexAt(Context.LastExpanded);
+            BestDistance = FMath::Min(BestDistance, Hex::Distance(Last, EndHex));
+        }
+
+        if (Deadline > 0 && FPlatformTime::Seconds() >= Deadline)
+        {
+            break;
+        }
+    }
+
+    return State;
+}
+
+float HexTimeSlicedSearch::GetProgress() const
+{
+    if (State != EHexSearchState::Running)
+    {
+        return 1.f;
+    }
+
+    return StartDistance > 0 ? 1.f - static_cast<float>(BestDistance) / StartDistance : 0.f;
+}
+
+bool HexTimeSlicedSearch::GetPath(std::vector<Hex>& OutPath) const
+{
+    if (State != EHexSearchState::Found)
+    {
+        OutPath.clear();
+        return false;
+    }
+
+    return HexPathfinder::WritePath(*Terrain, Context, StartHex, EndHex, OutPath);
+}
+
+bool HexTimeSlicedSearch::GetPath(HexPath& OutPath) const
+{
+    if (State != EHexSearchState::Found)
+    {
+        OutPath.Clear();
+        return false;
+    }
+
+    return HexPathfinder::WritePath(*Terrain, Context, StartHex, EndHex, OutPath);
+}
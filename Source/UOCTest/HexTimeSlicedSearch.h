@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "Hex.h"
+#include "HexPath.h"
+#include "HexPathfinder.h"
+#include "HexTerrain.h"
+
+// A* that can be paused between frames. Owns its open list and closed set, so any number of
+// searches can be in flight at once and each Step continues where the last one stopped.
+class UOCTEST_API HexTimeSlicedSearch
+{
+public:
+    // Starts a new search, nothing is expanded until Step
+    void Start(const HexTerrain* InTerrain, const Hex& InStart, const Hex& InEnd,
+        const HexSearchSettings& InSettings = HexSearchSettings(), const HexLandmarks* InLandmarks = nullptr);
+
+    // Starts over with the same query, call after the terrain changed
+    void Restart();
+
+    // Ends the search without a path
+    void Fail() { State = EHexSearchState::NotFound; }
+
+    // Expands at most MaxExpansions nodes, and stops earlier once MaxMicroseconds have passed when it isn't 0
+    EHexSearchState Step(int MaxExpansions, double MaxMicroseconds = 0);
+
+    EHexSearchState GetState() const { return State; }
+    bool IsRunning() const { return State == EHexSearchState::Running; }
+    bool UsesLandmarks() const { return Settings.Heuristic == EHexHeuristic::Landmarks; }
+
+    // 0 when started, 1 when done. Based on how close the best expanded node got to End, so it can move backwards.
+    float GetProgress() const;
+
+    int GetNodesExpanded() const { return Context.NodesExpanded; }
+
+    const Hex& GetStart() const { return StartHex; }
+    const Hex& GetEnd() const { return EndHex; }
+
+    // Only valid once the state is Found
+    bool GetPath(std::vector<Hex>& OutPath) const;
+    bool GetPath(HexPath& OutPath) const;
+
+private:
+    const HexTerrain* Terrain = nullptr;
+    const HexLandmarks* Landmarks = nullptr;
+    HexSearchSettings Settings;
+    Hex StartHex;
+    Hex EndHex;
+
+    HexSearchContext Context;
+    EHexSearchState State = EHexSearchState::NotFound;
+
+    // Hex distance from Start to End, and the smallest one of any expanded node
+    int StartDistance = 0;
+    int BestDistance = 0;
+};
@@ -149,18 +149,54 @@ void APlayerCamera::SetupPlayerInputComponent(UInputComponent* PlayerInputCompon
 
 void APlayerCamera::OnMouseClicked()
 {
-	AUOCTestGameMode* GameMode = Cast<AUOCTestGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+	AHexGridManager* GridManager = GetGridManager();
 	FVector ClickLocation = GetMouseWorldLocation();
-	Hex Tile = GameMode->GridManager->WorldToHex(ClickLocation);
-	AHexTile* HexTile = GameMode->GridManager->GetTileByHex(Tile);
-	if (HexTile)
+	Hex Tile = GridManager->WorldToHex(ClickLocation);
+	const EHexTypes OldType = GridManager->GetHexType(Tile);
+	// Instanced and streamed grids have no tile actors, the terrain decides what can be edited
+	if (OldType != EHexTypes::Invalid)
 	{
-		HexTile->ShuffleMaterials();
-	    EHexTypes NewType = static_cast<EHexTypes>((static_cast<int>(HexTile->TileType) + 1) % static_cast<int>(EHexTypes::MAX));
-	    HexTile->SetType(NewType, GameMode->GridManager->GetMaterial(NewType));
+		if (AHexTile* HexTile = GridManager->GetTileByHex(Tile))
+		{
+			HexTile->ShuffleMaterials();
+		}
+	    // Cycles through the real types, painting a tile Invalid would make it unclickable
+	    const EHexTypes NewType = static_cast<EHexTypes>(static_cast<int>(OldType) % (static_cast<int>(EHexTypes::MAX) - 1) + 1);
+	    if (HasAuthority())
+	    {
+	        GridManager->SetHexType(Tile, NewType);
+	    }
+	    else
+	    {
+	        ServerSetHexType(Tile.Q, Tile.R, NewType);
+	    }
 	}
 }
 
+void APlayerCamera::ServerSetHexType_Implementation(const int32 Q, const int32 R, const EHexTypes Type)
+{
+    AHexGridManager* GridManager = GetGridManager();
+    if (GridManager && Type != EHexTypes::Invalid && Type < EHexTypes::MAX)
+    {
+        GridManager->SetHexType(Hex(Q, R), Type);
+    }
+}
+
+AHexGridManager* APlayerCamera::GetGridManager() const
+{
+    if (const AUOCTestGameMode* GameMode = Cast<AUOCTestGameMode>(UGameplayStatics::GetGameMode(GetWorld())))
+    {
+        return GameMode->GridManager;
+    }
+
+    if (!GridManagerCache.IsValid())
+    {
+        GridManagerCache = Cast<AHexGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AHexGridManager::StaticClass()));
+    }
+
+    return GridManagerCache.Get();
+}
+
 FVector APlayerCamera::GetMouseWorldLocation() const
 {
 	FVector2D MousePosition;
@@ -177,26 +213,32 @@ FVector APlayerCamera::GetMouseWorldLocation() const
 
 FVector APlayerCamera::GetMouseWorldLocation(FVector2D& MousePosition) const
 {
-    FVector StartLocation = CameraComponent->GetComponentLocation();
     FVector WorldOrigin;
     FVector WorldDirection;
     APlayerController* PlayerController = Cast<APlayerController>(GetController());
-    if (UGameplayStatics::DeprojectScreenToWorld(PlayerController, MousePosition, WorldOrigin, WorldDirection))
+    if (!UGameplayStatics::DeprojectScreenToWorld(PlayerController, MousePosition, WorldOrigin, WorldDirection))
     {
-        FHitResult Hit;
-        bool Success = GetWorld()->LineTraceSingleByChannel(
-            Hit,
-            WorldOrigin,
-            StartLocation + WorldDirection * 20000.0f,
-            TraceChannel);
+        return FVector();
+    }
 
-        if (Success)
+    // Elevated terrain needs collision to be picked, the plane would miss it
+    if (TracePicking)
+    {
+        FHitResult Hit;
+        if (GetWorld()->LineTraceSingleByChannel(Hit, WorldOrigin, WorldOrigin + WorldDirection * TraceDistance, TraceChannel))
         {
             return Hit.ImpactPoint;
         }
     }
 
-    return FVector();
+    // The grid is flat, intersect the cursor ray with its plane instead of the physics scene
+    if (FMath::Abs(WorldDirection.Z) < KINDA_SMALL_NUMBER)
+    {
+        return FVector();
+    }
+
+    const double Distance = (GridPlaneHeight - WorldOrigin.Z) / WorldDirection.Z;
+    return Distance >= 0 ? WorldOrigin + WorldDirection * Distance : FVector();
 }
 
 void APlayerCamera::MoveCamera(const FInputActionValue& Value)
@@ -296,21 +338,23 @@ void APlayerCamera::EndDragCamera(const FInputActionValue& Value)
 
 void APlayerCamera::OnRightMouseClicked()
 {
-	AUOCTestGameMode* GameMode = Cast<AUOCTestGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+	AHexGridManager* GridManager = GetGridManager();
 	FVector ClickLocation = GetMouseWorldLocation();
-	StartHex = GameMode->GridManager->WorldToHex(ClickLocation);
+	StartHex = GridManager->WorldToHex(ClickLocation);
+    SelectionKeyValid = false;
 }
 
 void APlayerCamera::OnRightMouseReleased()
 {
-	AUOCTestGameMode* GameMode = Cast<AUOCTestGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+	AHexGridManager* GridManager = GetGridManager();
 
-    GameMode->GridManager->UnselectHexes();
+    GridManager->UnselectHexes();
+    SelectionKeyValid = false;
 
 	
 	// for (auto &Value : Hexes)
 	// {
-	// 	AHexTile* HexTile = GameMode->GridManager->GetTileByHex(Value);
+	// 	AHexTile* HexTile = GridManager->GetTileByHex(Value);
 	// 	if (HexTile)
 	// 	{
 	// 		HexTile->ShuffleMaterials();
@@ -320,66 +364,82 @@ void APlayerCamera::OnRightMouseReleased()
 
 void APlayerCamera::OnRightMouseHold()
 {
-    const AUOCTestGameMode* GameMode = Cast<AUOCTestGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+    AHexGridManager* GridManager = GetGridManager();
     const FVector ClickLocation = GetMouseWorldLocation();
-	EndHex = GameMode->GridManager->WorldToHex(ClickLocation);
-
-    // Unselect hexes
-    GameMode->GridManager->UnselectHexes();
+	EndHex = GridManager->WorldToHex(ClickLocation);
 
-    // Select Line
-    std::vector<Hex> Hexes = GameMode->GridManager->GetHexesInRange(StartHex, GameMode->GridManager->Distance(StartHex, EndHex));
-    GameMode->GridManager->SelectHexes(Hexes);
+    // Select movement range, dragging N hexes buys as much movement as N grass tiles
+    if (UpdateSelectionKey(GridManager->GetTerrainVersion()))
+    {
+        const float Budget = GridManager->Distance(StartHex, EndHex) * GridManager->GetTypeCost(EHexTypes::Grass);
+        GridManager->SetSelection(GridManager->GetMovementRange(StartHex, Budget));
+    }
     
 	DrawLine();
 }
 
 void APlayerCamera::OnRightMouseModifiedClicked()
 {
-    const AUOCTestGameMode* GameMode = Cast<AUOCTestGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+    AHexGridManager* GridManager = GetGridManager();
     const FVector ClickLocation = GetMouseWorldLocation();
-    StartHex = GameMode->GridManager->WorldToHex(ClickLocation);
+    StartHex = GridManager->WorldToHex(ClickLocation);
+    SelectionKeyValid = false;
 }
 
 void APlayerCamera::OnRightMouseModifiedHold()
 {
-    const AUOCTestGameMode* GameMode = Cast<AUOCTestGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+    AHexGridManager* GridManager = GetGridManager();
     const FVector MouseLocation = GetMouseWorldLocation();
-    EndHex = GameMode->GridManager->WorldToHex(MouseLocation);
-
-    // Unselect hexes
-    GameMode->GridManager->UnselectHexes();
+    EndHex = GridManager->WorldToHex(MouseLocation);
 
     // Select Line
-    //std::vector<Hex> Hexes = GameMode->GridManager->GetHexLine(StartHex, EndHex);
-    std::vector<Hex> Hexes = GameMode->GridManager->GetShortestPath(StartHex, EndHex);
-    GameMode->GridManager->SelectHexes(Hexes);
+    //std::vector<Hex> Hexes = GridManager->GetHexLine(StartHex, EndHex);
+    if (UpdateSelectionKey(GridManager->GetTerrainVersion()))
+    {
+        GridManager->GetIncrementalPath(StartHex, EndHex, PreviewPath);
+        GridManager->SetSelection(PreviewPath);
+    }
 
-    // Draw line
-    DrawLine(FColor::Red, true);
+    // Draw path
+    DrawLine(PreviewPath, FColor::Red, true);
 }
 
 void APlayerCamera::OnRightMouseModifiedReleased()
 {
-    const AUOCTestGameMode* GameMode = Cast<AUOCTestGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
+    AHexGridManager* GridManager = GetGridManager();
     const FVector ClickLocation = GetMouseWorldLocation();
-    StartHex = GameMode->GridManager->WorldToHex(ClickLocation);
+    StartHex = GridManager->WorldToHex(ClickLocation);
 
     // Unselect hexes
-    GameMode->GridManager->UnselectHexes();
+    GridManager->UnselectHexes();
+    SelectionKeyValid = false;
+}
+
+bool APlayerCamera::UpdateSelectionKey(const uint32 TerrainVersion)
+{
+    if (SelectionKeyValid && SelectionStartHex == StartHex && SelectionEndHex == EndHex && SelectionTerrainVersion == TerrainVersion)
+    {
+        return false;
+    }
+
+    SelectionKeyValid = true;
+    SelectionStartHex = StartHex;
+    SelectionEndHex = EndHex;
+    SelectionTerrainVersion = TerrainVersion;
+    return true;
 }
 
 void APlayerCamera::DrawLine(const FColor Color, bool DrawDots) const
 {
-    const AUOCTestGameMode* GameMode = Cast<AUOCTestGameMode>(UGameplayStatics::GetGameMode(GetWorld()));
-    const FVector StartLocation = GameMode->GridManager->HexToWorldLocation(StartHex) + FVector::UpVector * 20.f;
-    const FVector EndLocation = GameMode->GridManager->HexToWorldLocation(EndHex) + FVector::UpVector * 20.f;
+    AHexGridManager* GridManager = GetGridManager();
+    const FVector StartLocation = GridManager->HexToWorldLocation(StartHex) + FVector::UpVector * 20.f;
+    const FVector EndLocation = GridManager->HexToWorldLocation(EndHex) + FVector::UpVector * 20.f;
 	DrawDebugLine(GetWorld(), StartLocation, EndLocation, Color, false, 0.f, 0, 10.f);
 
     if (DrawDots)
     {
         float Distance = (EndLocation - StartLocation).Size();
-        const int HexDistance = GameMode->GridManager->Distance(StartHex, EndHex);
+        const int HexDistance = GridManager->Distance(StartHex, EndHex);
         float Step = Distance / HexDistance;
         FVector Direction = (EndLocation - StartLocation).GetSafeNormal();
 
@@ -390,6 +450,31 @@ void APlayerCamera::DrawLine(const FColor Color, bool DrawDots) const
             DrawDebugCircle(GetWorld(), Transform.ToMatrixWithScale(), 15.f, 32, Color, false, 0.f, 0);
         }
     }
-	// int Distance = GameMode->GridManager->Distance(StartHex, EndHex);
+	// int Distance = GridManager->Distance(StartHex, EndHex);
 	// GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Cyan, FString::Printf(TEXT("Distance: %d"), Distance)); // int
+}
+
+void APlayerCamera::DrawLine(const HexPath& Path, const FColor Color, bool DrawDots) const
+{
+    AHexGridManager* GridManager = GetGridManager();
+
+    FVector PreviousLocation;
+    bool First = true;
+    for (const Hex& H : Path)
+    {
+        const FVector CenterLocation = GridManager->HexToWorldLocation(H) + FVector::UpVector * 20.f;
+        if (!First)
+        {
+            DrawDebugLine(GetWorld(), PreviousLocation, CenterLocation, Color, false, 0.f, 0, 10.f);
+        }
+
+        if (DrawDots)
+        {
+            FTransform Transform(FRotator(90.f, 0.f, 0.f), CenterLocation);
+            DrawDebugCircle(GetWorld(), Transform.ToMatrixWithScale(), 15.f, 32, Color, false, 0.f, 0);
+        }
+
+        PreviousLocation = CenterLocation;
+        First = false;
+    }
 }
\ No newline at end of file
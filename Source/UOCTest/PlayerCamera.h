@@ -2,8 +2,12 @@
 
 #pragma once
 
+#include <vector>
+
 #include "CoreMinimal.h"
 #include "Hex.h"
+#include "HexEnum.h"
+#include "HexPath.h"
 #include "InputAction.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/FloatingPawnMovement.h"
@@ -11,6 +15,8 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "PlayerCamera.generated.h"
 
+class AHexGridManager;
+
 UCLASS()
 class UOCTEST_API APlayerCamera : public APawn
 {
@@ -29,6 +35,13 @@ public:
 	// When Left Mouse Button is pressed
 	void OnMouseClicked();
 
+    // Clients can't edit the grid themselves, the server applies the change and replicates it back
+    UFUNCTION(Server, Reliable)
+    void ServerSetHexType(int32 Q, int32 R, EHexTypes Type);
+
+    // The game mode's grid manager, clients have no game mode and look it up in the world
+    AHexGridManager* GetGridManager() const;
+
     // When Right Mouse Button is pressed
 	void OnRightMouseClicked();
 
@@ -50,6 +63,9 @@ public:
     // Draw debug line
 	void DrawLine(const FColor Color = FColor::Blue, bool DrawDots = false) const;
 
+    // Draw debug line along the hexes of a path
+    void DrawLine(const HexPath& Path, const FColor Color = FColor::Blue, bool DrawDots = false) const;
+
     // Used for converting screen to world space coordinates
 	FVector GetMouseWorldLocation() const;
     
@@ -82,6 +98,20 @@ public:
     // Ended drag on this hex
     Hex EndHex;
 
+    // Reused by the path preview so it doesn't allocate every frame
+    HexPath PreviewPath;
+
+    // Returns false when the selection already shows StartHex..EndHex on this terrain, otherwise remembers them
+    bool UpdateSelectionKey(uint32 TerrainVersion);
+
+    // Input the current selection was built from
+    Hex SelectionStartHex;
+    Hex SelectionEndHex;
+    uint32 SelectionTerrainVersion = 0;
+    bool SelectionKeyValid = false;
+
+    mutable TWeakObjectPtr<AHexGridManager> GridManagerCache;
+
 
 protected:
 	// Called when the game starts or when spawned
@@ -100,6 +130,18 @@ private:
 	UPROPERTY()
 	TEnumAsByte<ECollisionChannel> TraceChannel;
 
+    // Picks the cursor with a physics trace first, for terrain above the grid plane. Needs
+    // AHexGridManager::TileCollision, otherwise the trace hits nothing and the plane answers.
+    UPROPERTY(EditAnywhere, Category="Camera | Picking")
+    bool TracePicking = false;
+
+    UPROPERTY(EditAnywhere, Category="Camera | Picking", meta = (ClampMin = "0"))
+    float TraceDistance = 20000.f;
+
+    // Height of the grid plane the cursor ray is intersected with
+    UPROPERTY(EditAnywhere, Category="Camera | Picking")
+    float GridPlaneHeight = 0.f;
+
 	UPROPERTY(EditAnywhere, Category="Camera | Actions")
 	const UInputAction* ClickAction;
 
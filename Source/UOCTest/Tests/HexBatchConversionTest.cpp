@@ -0,0 +1,215 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include <cmath>
+#include <vector>
+
+#include "HexBatchConversion.h"
+#include "HexGridManager.h"
+
+namespace
+{
+    struct FHexWorldPoints
+    {
+        std::vector<double> X;
+        std::vector<double> Y;
+
+        void Add(const double InX, const double InY)
+        {
+            X.push_back(InX);
+            Y.push_back(InY);
+        }
+
+        int Num() const { return static_cast<int>(X.size()); }
+    };
+
+    // Inverse of AHexGridManager::LocationToFractionalHex, lands on or next to the point with these fractional coordinates
+    void AddFractional(FHexWorldPoints& Points, const double Q, const double R, const double Size)
+    {
+        const double X = Size * std::sqrt(3.0) * (R + Q / 2.0);
+        const double Y = Size * 1.5 * Q;
+
+        // The exact point and its neighbors one ulp away on both axes
+        for (const double StepX : { -1.0, 0.0, 1.0 })
+        {
+            for (const double StepY : { -1.0, 0.0, 1.0 })
+            {
+                Points.Add(StepX == 0.0 ? X : std::nextafter(X, StepX * HUGE_VAL), StepY == 0.0 ? Y : std::nextafter(Y, StepY * HUGE_VAL));
+            }
+        }
+    }
+
+    // Centers, edge midpoints and corners of the hexes around the origin and far out, plus random points
+    FHexWorldPoints MakeTestPoints(const double Size, const int RandomCount)
+    {
+        FHexWorldPoints Points;
+        for (const int Offset : { 0, 100000 })
+        {
+            for (int Q = -4; Q <= 4; Q++)
+            {
+                for (int R = -4; R <= 4; R++)
+                {
+                    // Halves are edges and ties of a single coordinate, thirds are corners
+                    for (const double Fraction : { 0.0, 0.5, -0.5, 1.0 / 3.0, -1.0 / 3.0, 2.0 / 3.0 })
+                    {
+                        AddFractional(Points, Offset + Q + Fraction, R, Size);
+                        AddFractional(Points, Offset + Q, R + Fraction, Size);
+                        AddFractional(Points, Offset + Q + Fraction, R - Fraction, Size);
+                    }
+                }
+            }
+        }
+
+        // Exact multiples of the tile size, zero and negative zero
+        for (int i = -20; i <= 20; i++)
+        {
+            Points.Add(i * Size * 0.5, 0.0);
+            Points.Add(0.0, i * Size * 0.25);
+            Points.Add(i * Size, i * Size * 0.75);
+        }
+        Points.Add(-0.0, -0.0);
+
+        FRandomStream Random(25);
+        for (int i = 0; i < RandomCount; i++)
+        {
+            Points.Add(Random.FRandRange(-1000000.f, 1000000.f) + Random.GetFraction(), Random.FRandRange(-1000000.f, 1000000.f) + Random.GetFraction());
+        }
+
+        return Points;
+    }
+
+    // Points from First on whose batch result differs from AHexGridManager::WorldToHex
+    int CountMismatches(const AHexGridManager& Manager, const FHexWorldPoints& Points, const int First, const std::vector<int32>& Q, const std::vector<int32>& R)
+    {
+        int Mismatches = 0;
+        for (int i = First; i < Points.Num(); i++)
+        {
+            const Hex Expected = Manager.WorldToHex(FVector(Points.X[i], Points.Y[i], 0.0));
+            Mismatches += Expected.Q != Q[i] || Expected.R != R[i];
+        }
+
+        return Mismatches;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexBatchWorldToHexTest, "UOCTest.Hex.BatchConversion.WorldToHexMatchesScalar",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexBatchWorldToHexTest::RunTest(const FString& Parameters)
+{
+    // The default object has the default OuterTileSize and never builds a grid
+    const AHexGridManager& Manager = *GetDefault<AHexGridManager>();
+    const FHexWorldPoints Points = MakeTestPoints(Manager.GetOuterTileSize(), 100000);
+
+    // Odd counts and offsets so every kernel ends with a scalar remainder
+    for (const int Skip : { 0, 1, 3 })
+    {
+        const int Count = Points.Num() - Skip;
+        std::vector<int32> Q(Points.Num(), INT32_MIN);
+        std::vector<int32> R(Points.Num(), INT32_MIN);
+        HexBatchConversion::WorldToHex(Points.X.data() + Skip, Points.Y.data() + Skip, Count, Manager.GetOuterTileSize(), Q.data() + Skip, R.data() + Skip);
+
+        TestEqual(FString::Printf(TEXT("Points on other hexes than the scalar path, skipping %d"), Skip), CountMismatches(Manager, Points, Skip, Q, R), 0);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexBatchHexRoundTest, "UOCTest.Hex.BatchConversion.HexRoundMatchesScalar",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexBatchHexRoundTest::RunTest(const FString& Parameters)
+{
+    std::vector<double> Q;
+    std::vector<double> R;
+
+    // Ties of one, two and all three coordinates, and the doubles right next to them
+    for (int i = -12; i <= 12; i++)
+    {
+        for (int j = -12; j <= 12; j++)
+        {
+            for (const double Denominator : { 2.0, 3.0, 6.0 })
+            {
+                const double BaseQ = i / Denominator;
+                const double BaseR = j / Denominator;
+                for (const double Direction : { -HUGE_VAL, 0.0, HUGE_VAL })
+                {
+                    Q.push_back(Direction == 0.0 ? BaseQ : std::nextafter(BaseQ, Direction));
+                    R.push_back(BaseR);
+                    Q.push_back(BaseQ);
+                    R.push_back(Direction == 0.0 ? BaseR : std::nextafter(BaseR, Direction));
+                }
+            }
+        }
+    }
+
+    FRandomStream Random(5);
+    for (int i = 0; i < 100000; i++)
+    {
+        Q.push_back(Random.FRandRange(-5000.f, 5000.f) + Random.GetFraction());
+        R.push_back(Random.FRandRange(-5000.f, 5000.f) + Random.GetFraction());
+    }
+
+    const int Count = static_cast<int>(Q.size());
+    std::vector<int32> OutQ(Count);
+    std::vector<int32> OutR(Count);
+    HexBatchConversion::HexRound(Q.data(), R.data(), Count, OutQ.data(), OutR.data());
+
+    int Mismatches = 0;
+    for (int i = 0; i < Count; i++)
+    {
+        const Hex Expected = Hex::Round(FractionalHex(Q[i], R[i], -Q[i] - R[i]));
+        Mismatches += Expected.Q != OutQ[i] || Expected.R != OutR[i];
+    }
+    TestEqual(TEXT("Rounded to other hexes than the scalar path"), Mismatches, 0);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexBatchWorldToHexPerfTest, "UOCTest.Hex.BatchConversion.WorldToHexThroughput",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FHexBatchWorldToHexPerfTest::RunTest(const FString& Parameters)
+{
+    const AHexGridManager& Manager = *GetDefault<AHexGridManager>();
+    const FHexWorldPoints Points = MakeTestPoints(Manager.GetOuterTileSize(), 4 * 1024 * 1024);
+    const int Count = Points.Num();
+    std::vector<int32> Q(Count);
+    std::vector<int32> R(Count);
+
+    // Best of a few runs, the first one also pages the output in
+    double BatchSeconds = TNumericLimits<double>::Max();
+    for (int Run = 0; Run < 5; Run++)
+    {
+        const double Start = FPlatformTime::Seconds();
+        HexBatchConversion::WorldToHex(Points.X.data(), Points.Y.data(), Count, Manager.GetOuterTileSize(), Q.data(), R.data());
+        BatchSeconds = FMath::Min(BatchSeconds, FPlatformTime::Seconds() - Start);
+    }
+
+    double ScalarSeconds = TNumericLimits<double>::Max();
+    int64 Checksum = 0;
+    for (int Run = 0; Run < 5; Run++)
+    {
+        const double Start = FPlatformTime::Seconds();
+        for (int i = 0; i < Count; i++)
+        {
+            const Hex H = Manager.WorldToHex(FVector(Points.X[i], Points.Y[i], 0.0));
+            Checksum += H.Q ^ H.R;
+        }
+        ScalarSeconds = FMath::Min(ScalarSeconds, FPlatformTime::Seconds() - Start);
+    }
+
+    AddInfo(FString::Printf(TEXT("%d points: batch %.2f ms (%.0f M points/s), scalar %.2f ms (%.0f M points/s), %.1fx, checksum %lld"),
+        Count, BatchSeconds * 1000.0, Count / BatchSeconds / 1000000.0, ScalarSeconds * 1000.0, Count / ScalarSeconds / 1000000.0,
+        ScalarSeconds / BatchSeconds, Checksum));
+
+    TestEqual(TEXT("Points on other hexes than the scalar path"), CountMismatches(Manager, Points, 0, Q, R), 0);
+    TestTrue(TEXT("Batch conversion is at least as fast as the scalar path"), BatchSeconds <= ScalarSeconds);
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include <algorithm>
+
+#include "Async/TaskGraphInterfaces.h"
+#include "HexBatchPathfinder.h"
+#include "HexTestTerrain.h"
+
+namespace
+{
+    std::vector<HexPathQuery> MakeQueries(const HexTerrain& Terrain, const int Count, const int32 Seed)
+    {
+        std::vector<HexPathQuery> Queries;
+        FRandomStream Random(Seed);
+        for (int i = 0; i < Count; i++)
+        {
+            Queries.push_back(HexPathQuery { Terrain.GetLayout().HexAt(HexTest::RandomPassable(Terrain, Random)),
+                Terrain.GetLayout().HexAt(HexTest::RandomPassable(Terrain, Random)) });
+        }
+
+        return Queries;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexBatchPathfinderSerialTest, "UOCTest.Hex.BatchPathfinder.MatchesSerialSearch",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexBatchPathfinderSerialTest::RunTest(const FString& Parameters)
+{
+    HexTerrain Terrain;
+    HexTest::MakeTerrain(Terrain, HexGridLayout(-40, 39, -40, 39), 8, 0.25f);
+    const std::vector<HexPathQuery> Queries = MakeQueries(Terrain, 64, 9);
+
+    // Every third query is skipped
+    std::vector<uint8> Skip(Queries.size());
+    for (int Query = 0; Query < static_cast<int>(Skip.size()); Query += 3)
+    {
+        Skip[Query] = 1;
+    }
+
+    HexSearchContext Context;
+    std::vector<Hex> Path;
+    HexBatchPathfinder Batch;
+    HexPathBatch Result;
+    for (const int ThreadCount : { 1, 4, 0 })
+    {
+        Batch.Solve(Terrain, Queries, Skip, Result, ThreadCount);
+        if (!TestEqual(FString::Printf(TEXT("Results with %d threads"), ThreadCount), Result.Num(), static_cast<int>(Queries.size())))
+        {
+            continue;
+        }
+
+        int Mismatches = 0;
+        for (int Query = 0; Query < Result.Num(); Query++)
+        {
+            const bool Found = !Skip[Query] && HexPathfinder::FindShortestPath(Terrain, Context, Queries[Query].Start, Queries[Query].End, Path);
+            if (Result.WasFound(Query) != Found || (Found && (Result.GetPathLength(Query) != static_cast<int>(Path.size()) ||
+                !std::equal(Path.begin(), Path.end(), Result.GetPath(Query)))))
+            {
+                Mismatches++;
+            }
+        }
+        TestEqual(FString::Printf(TEXT("Queries that differ from the serial search with %d threads"), ThreadCount), Mismatches, 0);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexBatchPathfinderScalingTest, "UOCTest.Hex.BatchPathfinder.ThreadScaling",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FHexBatchPathfinderScalingTest::RunTest(const FString& Parameters)
+{
+    HexTerrain Terrain;
+    HexTest::MakeTerrain(Terrain, HexGridLayout(-128, 127, -128, 127), 10, 0.1f);
+    const std::vector<HexPathQuery> Queries = MakeQueries(Terrain, 256, 12);
+    const std::vector<uint8> Skip;
+
+    HexBatchPathfinder Batch;
+    HexPathBatch Result;
+    double SingleSeconds = 0;
+    double FourSeconds = 0;
+    for (const int ThreadCount : { 1, 2, 4, 8 })
+    {
+        // Warm up the worker buffers, then keep the best of three batches
+        Batch.Solve(Terrain, Queries, Skip, Result, ThreadCount);
+
+        double Seconds = TNumericLimits<double>::Max();
+        for (int Run = 0; Run < 3; Run++)
+        {
+            const double Start = FPlatformTime::Seconds();
+            Batch.Solve(Terrain, Queries, Skip, Result, ThreadCount);
+            Seconds = FMath::Min(Seconds, FPlatformTime::Seconds() - Start);
+        }
+
+        SingleSeconds = ThreadCount == 1 ? Seconds : SingleSeconds;
+        FourSeconds = ThreadCount == 4 ? Seconds : FourSeconds;
+        AddInfo(FString::Printf(TEXT("%d threads: %d queries in %.2f ms, %.2fx"), ThreadCount, Result.Num(), Seconds * 1000.0, SingleSeconds / Seconds));
+    }
+
+    // Four threads need three workers besides the calling thread
+    if (FTaskGraphInterface::Get().GetNumWorkerThreads() >= 3)
+    {
+        TestTrue(TEXT("Four threads are at least twice as fast as one"), FourSeconds * 2.0 <= SingleSeconds);
+    }
+
+    return true;
+}
+
+#endif
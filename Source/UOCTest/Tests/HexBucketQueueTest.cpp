@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HexPathfinder.h"
+#include "HexTestTerrain.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexBucketQueueOrderTest, "UOCTest.Hex.BucketQueue.Order",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexBucketQueueOrderTest::RunTest(const FString& Parameters)
+{
+    HexBucketQueue Queue;
+    for (int Round = 0; Round < 2; Round++)
+    {
+        Queue.Reset();
+        Queue.Push(10, 5, false);
+        Queue.Push(11, 2, false);
+        Queue.Push(12, 5, true);
+        Queue.Push(13, 9, false);
+
+        TestEqual(TEXT("Lowest key first"), Queue.Pop(), 11);
+
+        // A key below the cursor still comes out next
+        Queue.Push(14, 1, false);
+        TestEqual(TEXT("Key below the cursor"), Queue.Pop(), 14);
+        TestEqual(TEXT("Preferred entry wins the tie"), Queue.Pop(), 12);
+        TestEqual(TEXT("Other entry of the tie"), Queue.Pop(), 10);
+        TestEqual(TEXT("Highest key last"), Queue.Pop(), 13);
+        TestTrue(TEXT("Queue is empty"), Queue.IsEmpty());
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexBucketQueuePerfTest, "UOCTest.Hex.BucketQueue.AgainstBinaryHeap",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FHexBucketQueuePerfTest::RunTest(const FString& Parameters)
+{
+    // Large open map, long queries between opposite sides
+    HexTerrain Terrain;
+    HexTest::MakeTerrain(Terrain, HexGridLayout(-256, 255, -256, 255), 4, 0.05f);
+    const HexGridLayout& Layout = Terrain.GetLayout();
+
+    struct FQuery
+    {
+        Hex Start;
+        Hex End;
+    };
+
+    std::vector<FQuery> Queries;
+    FRandomStream Random(11);
+    while (Queries.size() < 100)
+    {
+        const int Start = Random.RandHelper(Layout.Height) + Random.RandHelper(Layout.Width / 8) * Layout.Height;
+        const int End = Terrain.Num() - 1 - Random.RandHelper(Layout.Height) - Random.RandHelper(Layout.Width / 8) * Layout.Height;
+        if (Terrain.IsPassable(Start) && Terrain.IsPassable(End))
+        {
+            Queries.push_back(FQuery { Layout.HexAt(Start), Layout.HexAt(End) });
+        }
+    }
+
+    struct FRun
+    {
+        double Seconds = 0;
+        int64 Nodes = 0;
+        double Cost = 0;
+        int Found = 0;
+    };
+
+    auto Measure = [&](const EHexOpenList OpenList, const EHexHeuristic Heuristic)
+    {
+        HexSearchSettings Settings;
+        Settings.OpenList = OpenList;
+        Settings.Heuristic = Heuristic;
+
+        HexSearchContext Context;
+        std::vector<Hex> Path;
+
+        // Grows the scratch arrays, the measured runs don't allocate
+        HexPathfinder::FindShortestPath(Terrain, Context, Queries[0].Start, Queries[0].End, Path, Settings);
+
+        FRun Run;
+        const double Start = FPlatformTime::Seconds();
+        for (const FQuery& Query : Queries)
+        {
+            if (HexPathfinder::FindShortestPath(Terrain, Context, Query.Start, Query.End, Path, Settings))
+            {
+                Run.Found++;
+                Run.Cost += HexTest::PathCost(Terrain, Path);
+            }
+            Run.Nodes += Context.NodesExpanded;
+        }
+        Run.Seconds = FPlatformTime::Seconds() - Start;
+        return Run;
+    };
+
+    for (const EHexHeuristic Heuristic : { EHexHeuristic::HexDistance, EHexHeuristic::Manhattan })
+    {
+        const TCHAR* Name = Heuristic == EHexHeuristic::HexDistance ? TEXT("HexDistance") : TEXT("Manhattan");
+        const FRun Heap = Measure(EHexOpenList::BinaryHeap, Heuristic);
+        const FRun Buckets = Measure(EHexOpenList::Buckets, Heuristic);
+
+        AddInfo(FString::Printf(TEXT("%s, %d tiles, %d queries: heap %.2f ms %lld nodes, buckets %.2f ms %lld nodes, %.2fx"),
+            Name, Terrain.Num(), static_cast<int>(Queries.size()), Heap.Seconds * 1000.0, Heap.Nodes, Buckets.Seconds * 1000.0, Buckets.Nodes,
+            Heap.Seconds / FMath::Max(Buckets.Seconds, 1e-9)));
+
+        TestEqual(FString::Printf(TEXT("%s paths found"), Name), Buckets.Found, Heap.Found);
+
+        // Integer costs keep the bucket queue exact, optimal searches agree on every path cost
+        if (Heuristic == EHexHeuristic::HexDistance)
+        {
+            TestEqual(FString::Printf(TEXT("%s total path cost"), Name), Buckets.Cost, Heap.Cost);
+            TestTrue(FString::Printf(TEXT("%s bucket queue is faster"), Name), Buckets.Seconds < Heap.Seconds);
+        }
+    }
+
+    return true;
+}
+
+#endif
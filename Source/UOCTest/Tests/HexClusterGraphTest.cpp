@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HexClusterGraph.h"
+#include "HexPathfinder.h"
+#include "HexTestTerrain.h"
+
+namespace
+{
+    // Two 4x4 clusters side by side. Row 1 of the right cluster is blocked, which splits it into
+    // row 0 and rows 2-3, and the border tile of row 1 cuts the remote side of the shared border
+    // while the local side stays one connected run.
+    const HexGridLayout SplitLayout(0, 7, 0, 3);
+
+    void BlockSplitRow(HexTerrain& Terrain, HexClusterGraph* Graph)
+    {
+        for (int Column = 4; Column < 8; Column++)
+        {
+            const int Index = Column * SplitLayout.Height + 1;
+            HexTest::SetTile(Terrain, Index, EHexTypes::Blocked);
+            if (Graph)
+            {
+                Graph->OnTileChanged(Index);
+            }
+        }
+    }
+
+    void TestSplitBorder(FAutomationTestBase& Test, const HexTerrain& Terrain, HexClusterGraph& Graph)
+    {
+        const Hex Start = SplitLayout.HexAt(0 * SplitLayout.Height + 2);
+        const Hex Goals[] = { SplitLayout.HexAt(7 * SplitLayout.Height + 0), SplitLayout.HexAt(7 * SplitLayout.Height + 3) };
+
+        std::vector<Hex> Path;
+        for (const Hex& Goal : Goals)
+        {
+            Test.TestTrue(FString::Printf(TEXT("Path to (%d, %d) found"), Goal.Q, Goal.R), Graph.FindPath(Start, Goal, Path));
+            Test.TestTrue(FString::Printf(TEXT("Path to (%d, %d) is valid"), Goal.Q, Goal.R), HexTest::IsValidPath(Terrain, Path, Start, Goal));
+        }
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexClusterGraphRemoteBlockedBorderTest, "UOCTest.Hex.ClusterGraph.RemoteBlockedBorder",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexClusterGraphRemoteBlockedBorderTest::RunTest(const FString& Parameters)
+{
+    // Blocked before the build
+    {
+        HexTerrain Terrain;
+        Terrain.Init(SplitLayout, EHexTypes::Dirt, HexTest::TypeCost(EHexTypes::Dirt), 1.f);
+        BlockSplitRow(Terrain, nullptr);
+
+        HexClusterGraph Graph;
+        Graph.Build(&Terrain, 4, Terrain.GetMinCost());
+        TestEqual(TEXT("Cluster count"), Graph.GetClusterCount(), 2);
+        TestSplitBorder(*this, Terrain, Graph);
+    }
+
+    // Blocked afterwards, only the touched clusters are rebuilt
+    {
+        HexTerrain Terrain;
+        Terrain.Init(SplitLayout, EHexTypes::Dirt, HexTest::TypeCost(EHexTypes::Dirt), 1.f);
+
+        HexClusterGraph Graph;
+        Graph.Build(&Terrain, 4, Terrain.GetMinCost());
+        BlockSplitRow(Terrain, &Graph);
+        TestSplitBorder(*this, Terrain, Graph);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexClusterGraphReachabilityTest, "UOCTest.Hex.ClusterGraph.Reachability",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexClusterGraphReachabilityTest::RunTest(const FString& Parameters)
+{
+    HexTerrain Terrain;
+    HexTest::MakeTerrain(Terrain, HexGridLayout(-24, 23, -24, 23), 1337, 0.3f);
+
+    HexClusterGraph Graph;
+    Graph.Build(&Terrain, 8, Terrain.GetMinCost());
+
+    // Every pair the flat search connects has to be connected by the cluster graph too
+    HexSearchContext Context;
+    std::vector<Hex> FlatPath;
+    std::vector<Hex> ClusterPath;
+    FRandomStream Random(7);
+    for (int Query = 0; Query < 200; Query++)
+    {
+        const Hex Start = Terrain.GetLayout().HexAt(HexTest::RandomPassable(Terrain, Random));
+        const Hex End = Terrain.GetLayout().HexAt(HexTest::RandomPassable(Terrain, Random));
+
+        const bool FlatFound = HexPathfinder::FindShortestPath(Terrain, Context, Start, End, FlatPath);
+        const bool ClusterFound = Graph.FindPath(Start, End, ClusterPath);
+        if (!TestEqual(FString::Printf(TEXT("Reachability of (%d, %d) -> (%d, %d)"), Start.Q, Start.R, End.Q, End.R), ClusterFound, FlatFound))
+        {
+            break;
+        }
+
+        if (ClusterFound)
+        {
+            TestTrue(TEXT("Cluster path is valid"), HexTest::IsValidPath(Terrain, ClusterPath, Start, End));
+        }
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexClusterGraphPerfTest, "UOCTest.Hex.ClusterGraph.AgainstFlatSearch",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FHexClusterGraphPerfTest::RunTest(const FString& Parameters)
+{
+    HexTerrain Terrain;
+    HexTest::MakeTerrain(Terrain, HexGridLayout(-256, 255, -256, 255), 6, 0.1f);
+    const HexGridLayout& Layout = Terrain.GetLayout();
+
+    HexClusterGraph Graph;
+    const double BuildStart = FPlatformTime::Seconds();
+    Graph.Build(&Terrain, 10, Terrain.GetMinCost());
+    const double BuildSeconds = FPlatformTime::Seconds() - BuildStart;
+
+    // Long queries, the case the abstract graph is for. The flat search uses the same exact heuristic as the graph,
+    // the default Manhattan estimate overshoots, it expands fewer nodes but misses the cheapest paths.
+    HexSearchSettings Settings;
+    Settings.Heuristic = EHexHeuristic::HexDistance;
+    HexSearchContext Context;
+    std::vector<Hex> FlatPath;
+    std::vector<Hex> ClusterPath;
+    FRandomStream Random(13);
+
+    int Queries = 0;
+    int Found = 0;
+    int64 FlatNodes = 0;
+    int64 ClusterNodes = 0;
+    double FlatSeconds = 0;
+    double ClusterSeconds = 0;
+    double FlatCost = 0;
+    double ClusterCost = 0;
+    while (Queries < 100)
+    {
+        const Hex Start = Layout.HexAt(HexTest::RandomPassable(Terrain, Random));
+        const Hex End = Layout.HexAt(HexTest::RandomPassable(Terrain, Random));
+        if (Hex::Distance(Start, End) < 200)
+        {
+            continue;
+        }
+        Queries++;
+
+        double Time = FPlatformTime::Seconds();
+        const bool FlatFound = HexPathfinder::FindShortestPath(Terrain, Context, Start, End, FlatPath, Settings);
+        FlatSeconds += FPlatformTime::Seconds() - Time;
+        FlatNodes += Context.NodesExpanded;
+
+        Time = FPlatformTime::Seconds();
+        const bool ClusterFound = Graph.FindPath(Start, End, ClusterPath);
+        ClusterSeconds += FPlatformTime::Seconds() - Time;
+        ClusterNodes += Graph.NodesExpanded;
+
+        TestEqual(TEXT("Both searches agree on reachability"), ClusterFound, FlatFound);
+        if (FlatFound && ClusterFound)
+        {
+            Found++;
+            FlatCost += HexTest::PathCost(Terrain, FlatPath);
+            ClusterCost += HexTest::PathCost(Terrain, ClusterPath);
+        }
+    }
+
+    AddInfo(FString::Printf(TEXT("%d tiles in %d clusters, built in %.2f ms"), Terrain.Num(), Graph.GetClusterCount(), BuildSeconds * 1000.0));
+    AddInfo(FString::Printf(TEXT("%d queries: flat %.3f ms %lld nodes, hierarchical %.3f ms %lld nodes per query, path cost %.1f%% of flat"),
+        Queries, FlatSeconds * 1000.0 / Queries, FlatNodes / Queries, ClusterSeconds * 1000.0 / Queries, ClusterNodes / Queries,
+        100.0 * ClusterCost / FMath::Max(FlatCost, 1.0)));
+
+    TestTrue(TEXT("Paths found"), Found > 0);
+    TestTrue(TEXT("Hierarchical search expands fewer nodes"), ClusterNodes < FlatNodes);
+    TestTrue(TEXT("Hierarchical search is faster"), ClusterSeconds < FlatSeconds);
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HexFlowField.h"
+#include "HexTestTerrain.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexFlowFieldTest, "UOCTest.Hex.FlowField.FollowsToGoalAtDijkstraCost",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexFlowFieldTest::RunTest(const FString& Parameters)
+{
+    HexTerrain Terrain;
+    HexTest::MakeTerrain(Terrain, HexGridLayout(-25, 24, -25, 24), 7, 0.25f);
+    const HexGridLayout& Layout = Terrain.GetLayout();
+
+    HexSearchContext Context;
+    HexFlowField Field;
+    FRandomStream Random(70);
+
+    for (int Goal = 0; Goal < 8; Goal++)
+    {
+        const int GoalIndex = HexTest::RandomPassable(Terrain, Random);
+        Field.Build(Terrain, GoalIndex, Context);
+        const std::vector<double> Expected = HexTest::Dijkstra(Terrain, GoalIndex, true);
+
+        // Every tile is finished once, outdated heap entries don't count
+        int Reachable = 0;
+        for (int Index = 0; Index < Terrain.Num(); Index++)
+        {
+            Reachable += Expected[Index] != INFINITY && Terrain.IsPassable(Index);
+        }
+        TestEqual(FString::Printf(TEXT("Goal %d: tiles expanded"), Goal), Context.NodesExpanded, Reachable);
+
+        int CostMismatches = 0;
+        int DirectionMismatches = 0;
+        int WalkFailures = 0;
+        for (int Index = 0; Index < Terrain.Num(); Index++)
+        {
+            const bool CanReach = Index != GoalIndex && Terrain.IsPassable(Index) && Expected[Index] != INFINITY;
+            DirectionMismatches += CanReach != (Field.GetDirection(Index) != HexFlowField::NoDirection);
+            if (!CanReach)
+            {
+                continue;
+            }
+
+            CostMismatches += !FMath::IsNearlyEqual(static_cast<double>(Field.GetCost(Index)), Expected[Index], 1e-3);
+
+            // Follow the directions, the walk has to reach the goal over passable tiles at the cheapest cost
+            std::vector<Hex> Path = { Layout.HexAt(Index) };
+            Hex Next;
+            while (Path.size() <= static_cast<size_t>(Terrain.Num()) && Field.GetNextHex(Path.back(), Next))
+            {
+                Path.push_back(Next);
+            }
+
+            const Hex GoalHex = Layout.HexAt(GoalIndex);
+            WalkFailures += !HexTest::IsValidPath(Terrain, Path, Path.front(), GoalHex)
+                || !FMath::IsNearlyEqual(HexTest::PathCost(Terrain, Path), Expected[Index], 1e-3);
+        }
+
+        TestEqual(FString::Printf(TEXT("Goal %d: tiles with a direction unlike reachability"), Goal), DirectionMismatches, 0);
+        TestEqual(FString::Printf(TEXT("Goal %d: tile costs unlike Dijkstra"), Goal), CostMismatches, 0);
+        TestEqual(FString::Printf(TEXT("Goal %d: walks that miss the goal or its cost"), Goal), WalkFailures, 0);
+    }
+
+    // A blocked goal leaves every tile without a direction
+    int BlockedGoal = 0;
+    while (Terrain.IsPassable(BlockedGoal))
+    {
+        BlockedGoal++;
+    }
+    Field.Build(Terrain, BlockedGoal, Context);
+
+    int Directions = 0;
+    for (int Index = 0; Index < Terrain.Num(); Index++)
+    {
+        Directions += Field.GetDirection(Index) != HexFlowField::NoDirection;
+    }
+    TestEqual(TEXT("Tiles with a direction towards a blocked goal"), Directions, 0);
+
+    return true;
+}
+
+#endif
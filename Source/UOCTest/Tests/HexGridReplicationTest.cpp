@@ -0,0 +1,177 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Editor.h"
+#include "EngineUtils.h"
+#include "HexGridManager.h"
+#include "Settings/LevelEditorPlaySettings.h"
+#include "Tests/AutomationEditorCommon.h"
+#include "UObject/StrongObjectPtr.h"
+
+namespace
+{
+    const TCHAR* HexLevel = TEXT("/Game/Binx/Levels/HexLevel");
+
+    // Seconds the session gets to join, build the grids and replicate an edit
+    constexpr double SessionTimeout = 60.0;
+
+    AHexGridManager* FindGridManager(const ENetMode NetMode)
+    {
+        for (const FWorldContext& Context : GEngine->GetWorldContexts())
+        {
+            UWorld* World = Context.World();
+            if (Context.WorldType == EWorldType::PIE && World && World->GetNetMode() == NetMode)
+            {
+                TActorIterator<AHexGridManager> It(World);
+                return It ? *It : nullptr;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Runs a listen server and one client in this process. Once both grids are ready the server
+    // edits a tile, the client has to see the edit through the replicated chunks.
+    class FHexListenServerEditCommand : public IAutomationLatentCommand
+    {
+    public:
+        explicit FHexListenServerEditCommand(FAutomationTestBase* InTest) :
+            Test(InTest) {}
+
+        virtual bool Update() override
+        {
+            switch (Step)
+            {
+            case EStep::Start:
+                Start();
+                return false;
+            case EStep::WaitForGrids:
+                return WaitForGrids();
+            case EStep::WaitForEdit:
+                return WaitForEdit();
+            default:
+                return EndSession();
+            }
+        }
+
+    private:
+        enum class EStep
+        {
+            Start,
+            WaitForGrids,
+            WaitForEdit,
+            End,
+        };
+
+        void Start()
+        {
+            PlaySettings.Reset(NewObject<ULevelEditorPlaySettings>());
+            PlaySettings->SetPlayNetMode(EPlayNetMode::PIE_ListenServer);
+            PlaySettings->SetPlayNumberOfClients(2);
+            PlaySettings->SetRunUnderOneProcess(true);
+            PlaySettings->bLaunchSeparateServer = false;
+
+            FRequestPlaySessionParams Params;
+            Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+            Params.EditorPlaySettings = PlaySettings.Get();
+            GEditor->RequestPlaySession(Params);
+
+            StartTime = FPlatformTime::Seconds();
+            Step = EStep::WaitForGrids;
+        }
+
+        bool WaitForGrids()
+        {
+            AHexGridManager* Server = FindGridManager(NM_ListenServer);
+            AHexGridManager* Client = FindGridManager(NM_Client);
+            if (!Server || !Client || !Server->IsGridReady() || !Client->IsGridReady())
+            {
+                return TimedOut(TEXT("Listen server and client grids didn't get ready"));
+            }
+
+            const HexTerrain& ServerTerrain = Server->GetTerrain();
+            const HexTerrain& ClientTerrain = Client->GetTerrain();
+            Test->TestTrue(TEXT("Client grid has the server layout"), ClientTerrain.GetLayout() == ServerTerrain.GetLayout());
+
+            int Mismatches = 0;
+            for (int Index = 0; Index < ServerTerrain.Num() && Index < ClientTerrain.Num(); Index++)
+            {
+                Mismatches += ServerTerrain.GetType(Index) != ClientTerrain.GetType(Index);
+            }
+            Test->TestEqual(TEXT("Tiles that differ after joining"), Mismatches, 0);
+
+            const int64 JoinBytes = Server->GetReplicatedTerrainBytes();
+            Test->AddInfo(FString::Printf(TEXT("Join snapshot: %lld bytes for %d tiles, target %lld bytes"),
+                JoinBytes, ServerTerrain.Num(), Server->GetJoinSnapshotTargetBytes()));
+            Test->TestTrue(TEXT("Join snapshot within target"), JoinBytes <= Server->GetJoinSnapshotTargetBytes());
+
+            // The middle tile, cycled to the next real type
+            EditedTile = ServerTerrain.GetLayout().HexAt(ServerTerrain.Num() / 2);
+            const EHexTypes OldType = Server->GetHexType(EditedTile);
+            EditedType = static_cast<EHexTypes>(static_cast<int>(OldType) % (static_cast<int>(EHexTypes::MAX) - 1) + 1);
+            Server->SetHexType(EditedTile, EditedType);
+            Test->TestEqual(TEXT("Server applied the edit"), Server->GetHexType(EditedTile), EditedType);
+
+            Step = EStep::WaitForEdit;
+            return false;
+        }
+
+        bool WaitForEdit()
+        {
+            const AHexGridManager* Client = FindGridManager(NM_Client);
+            if (!Client || Client->GetHexType(EditedTile) != EditedType)
+            {
+                return TimedOut(TEXT("Client didn't receive the tile edit"));
+            }
+
+            Step = EStep::End;
+            return false;
+        }
+
+        bool EndSession()
+        {
+            if (GEditor->IsPlaySessionInProgress())
+            {
+                GEditor->RequestEndPlayMap();
+                return false;
+            }
+
+            return true;
+        }
+
+        // Keeps waiting until the timeout, then fails the test and ends the session
+        bool TimedOut(const TCHAR* Error)
+        {
+            if (FPlatformTime::Seconds() - StartTime < SessionTimeout)
+            {
+                return false;
+            }
+
+            Test->AddError(Error);
+            Step = EStep::End;
+            return false;
+        }
+
+        FAutomationTestBase* Test;
+        TStrongObjectPtr<ULevelEditorPlaySettings> PlaySettings;
+        EStep Step = EStep::Start;
+        double StartTime = 0.0;
+        Hex EditedTile;
+        EHexTypes EditedType = EHexTypes::Invalid;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexGridListenServerTest, "UOCTest.Hex.Replication.ListenServerEdit",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FHexGridListenServerTest::RunTest(const FString& Parameters)
+{
+    FAutomationEditorCommonUtils::LoadMap(HexLevel);
+    ADD_LATENT_AUTOMATION_COMMAND(FHexListenServerEditCommand(this));
+    return true;
+}
+
+#endif
@@ -0,0 +1,249 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HexLandmarks.h"
+#include "HexPathfinder.h"
+#include "HexTestTerrain.h"
+
+namespace
+{
+    struct FHexQuery
+    {
+        Hex Start;
+        Hex End;
+    };
+
+    const TCHAR* HeuristicName(const EHexHeuristic Heuristic)
+    {
+        switch (Heuristic)
+        {
+        case EHexHeuristic::Manhattan: return TEXT("Manhattan");
+        case EHexHeuristic::HexDistance: return TEXT("HexDistance");
+        case EHexHeuristic::Weighted: return TEXT("Weighted");
+        case EHexHeuristic::Landmarks: return TEXT("Landmarks");
+        default: return TEXT("Unknown");
+        }
+    }
+
+    struct FHexHeuristicErrors
+    {
+        int FoundMismatches = 0;
+        int OverOptimum = 0;
+        int OverBound = 0;
+    };
+
+    // Every query of Queries from one start against the Dijkstra costs of that start
+    void CheckAgainstDijkstra(const HexTerrain& Terrain, const std::vector<FHexQuery>& Queries, const HexSearchSettings& Settings,
+        const HexLandmarks* Landmarks, HexSearchContext& Context, FHexHeuristicErrors& Errors)
+    {
+        const HexGridLayout& Layout = Terrain.GetLayout();
+        std::vector<Hex> Path;
+        int DijkstraSource = INDEX_NONE;
+        std::vector<double> Optimum;
+        for (const FHexQuery& Query : Queries)
+        {
+            if (Layout.IndexOf(Query.Start) != DijkstraSource)
+            {
+                DijkstraSource = Layout.IndexOf(Query.Start);
+                Optimum = HexTest::Dijkstra(Terrain, DijkstraSource);
+            }
+
+            const double Expected = Optimum[Layout.IndexOf(Query.End)];
+            const bool Found = HexPathfinder::FindShortestPath(Terrain, Context, Query.Start, Query.End, Path, Settings, Landmarks);
+            Errors.FoundMismatches += Found != (Expected != INFINITY);
+            if (!Found || Expected == INFINITY)
+            {
+                continue;
+            }
+
+            // Tile costs are whole numbers, anything above the optimum is at least one more
+            const double Cost = HexTest::PathCost(Terrain, Path);
+            Errors.OverOptimum += Cost > Expected + 0.5;
+            Errors.OverBound += Cost > Expected * Settings.Epsilon + 0.5;
+        }
+    }
+
+    // Queries grouped by start, so one Dijkstra answers a group
+    std::vector<FHexQuery> MakeQueries(const HexTerrain& Terrain, FRandomStream& Random, const int Starts, const int EndsPerStart)
+    {
+        std::vector<FHexQuery> Queries;
+        for (int Start = 0; Start < Starts; Start++)
+        {
+            const Hex StartHex = Terrain.GetLayout().HexAt(HexTest::RandomPassable(Terrain, Random));
+            for (int End = 0; End < EndsPerStart; End++)
+            {
+                // Blocked ends too, every search has to give up on them
+                Queries.push_back(FHexQuery { StartHex, Terrain.GetLayout().HexAt(Random.RandHelper(Terrain.Num())) });
+            }
+        }
+
+        return Queries;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexHeuristicOptimalityTest, "UOCTest.Hex.Heuristic.CostAgainstDijkstra",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexHeuristicOptimalityTest::RunTest(const FString& Parameters)
+{
+    HexTerrain Terrain;
+    HexTest::MakeTerrain(Terrain, HexGridLayout(-30, 29, -30, 29), 9, 0.25f);
+
+    HexSearchContext Context;
+    HexLandmarks Landmarks;
+    FRandomStream Random(90);
+
+    // The second and third rounds run on edited terrain, the landmarks are rebuilt because they are dirty
+    for (int Round = 0; Round < 3; Round++)
+    {
+        if (Round > 0)
+        {
+            for (int Edit = 0; Edit < Terrain.Num() / 10; Edit++)
+            {
+                const EHexTypes Types[] = { EHexTypes::Dirt, EHexTypes::Grass, EHexTypes::Water, EHexTypes::Blocked };
+                HexTest::SetTile(Terrain, Random.RandHelper(Terrain.Num()), Types[Random.RandHelper(4)]);
+            }
+            Landmarks.Dirty = true;
+        }
+
+        if (Landmarks.Dirty)
+        {
+            Landmarks.Build(Terrain, 8, Context);
+        }
+        TestFalse(FString::Printf(TEXT("Round %d: landmarks are clean after the rebuild"), Round), Landmarks.Dirty);
+
+        const std::vector<FHexQuery> Queries = MakeQueries(Terrain, Random, 10, 30);
+
+        struct FCase
+        {
+            EHexOpenList OpenList;
+            EHexHeuristic Heuristic;
+            float Epsilon;
+        };
+
+        // The bucket queue rounds priorities, only the exact heuristics go through it
+        const FCase Cases[] = {
+            { EHexOpenList::BinaryHeap, EHexHeuristic::HexDistance, 1.f },
+            { EHexOpenList::BinaryHeap, EHexHeuristic::Landmarks, 1.f },
+            { EHexOpenList::BinaryHeap, EHexHeuristic::Weighted, 1.5f },
+            { EHexOpenList::BinaryHeap, EHexHeuristic::Weighted, 3.f },
+            { EHexOpenList::Buckets, EHexHeuristic::HexDistance, 1.f },
+            { EHexOpenList::Buckets, EHexHeuristic::Landmarks, 1.f },
+        };
+
+        for (const FCase& Case : Cases)
+        {
+            HexSearchSettings Settings;
+            Settings.OpenList = Case.OpenList;
+            Settings.Heuristic = Case.Heuristic;
+            Settings.Epsilon = Case.Epsilon;
+
+            FHexHeuristicErrors Errors;
+            CheckAgainstDijkstra(Terrain, Queries, Settings, &Landmarks, Context, Errors);
+
+            const FString Name = FString::Printf(TEXT("Round %d, %s, %s, epsilon %.1f"), Round, HeuristicName(Case.Heuristic),
+                Case.OpenList == EHexOpenList::Buckets ? TEXT("buckets") : TEXT("heap"), Case.Epsilon);
+            TestEqual(FString::Printf(TEXT("%s: queries that disagree with Dijkstra on reachability"), *Name), Errors.FoundMismatches, 0);
+            if (Case.Heuristic == EHexHeuristic::Weighted)
+            {
+                TestEqual(FString::Printf(TEXT("%s: paths above epsilon times the optimum"), *Name), Errors.OverBound, 0);
+            }
+            else
+            {
+                TestEqual(FString::Printf(TEXT("%s: paths above the optimum"), *Name), Errors.OverOptimum, 0);
+            }
+        }
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexHeuristicNodesTest, "UOCTest.Hex.Heuristic.NodesExpanded",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FHexHeuristicNodesTest::RunTest(const FString& Parameters)
+{
+    // Large open map, long queries between opposite sides
+    HexTerrain Terrain;
+    HexTest::MakeTerrain(Terrain, HexGridLayout(-256, 255, -256, 255), 4, 0.1f);
+    const HexGridLayout& Layout = Terrain.GetLayout();
+
+    std::vector<FHexQuery> Queries;
+    FRandomStream Random(19);
+    while (Queries.size() < 100)
+    {
+        const int Start = Random.RandHelper(Layout.Height) + Random.RandHelper(Layout.Width / 8) * Layout.Height;
+        const int End = Terrain.Num() - 1 - Random.RandHelper(Layout.Height) - Random.RandHelper(Layout.Width / 8) * Layout.Height;
+        if (Terrain.IsPassable(Start) && Terrain.IsPassable(End))
+        {
+            Queries.push_back(FHexQuery { Layout.HexAt(Start), Layout.HexAt(End) });
+        }
+    }
+
+    HexSearchContext Context;
+    HexLandmarks Landmarks;
+    const double BuildStart = FPlatformTime::Seconds();
+    Landmarks.Build(Terrain, 8, Context);
+    AddInfo(FString::Printf(TEXT("%d tiles, %d queries, 8 landmarks built in %.2f ms"), Terrain.Num(), static_cast<int>(Queries.size()),
+        (FPlatformTime::Seconds() - BuildStart) * 1000.0));
+
+    struct FRun
+    {
+        double Seconds = 0;
+        int64 Nodes = 0;
+        double Cost = 0;
+    };
+
+    auto Measure = [&](const EHexHeuristic Heuristic, const float Epsilon)
+    {
+        HexSearchSettings Settings;
+        Settings.Heuristic = Heuristic;
+        Settings.Epsilon = Epsilon;
+        std::vector<Hex> Path;
+
+        // Grows the scratch arrays, the measured runs don't allocate
+        HexPathfinder::FindShortestPath(Terrain, Context, Queries[0].Start, Queries[0].End, Path, Settings, &Landmarks);
+
+        FRun Run;
+        const double Start = FPlatformTime::Seconds();
+        for (const FHexQuery& Query : Queries)
+        {
+            if (HexPathfinder::FindShortestPath(Terrain, Context, Query.Start, Query.End, Path, Settings, &Landmarks))
+            {
+                Run.Cost += HexTest::PathCost(Terrain, Path);
+            }
+            Run.Nodes += Context.NodesExpanded;
+        }
+        Run.Seconds = FPlatformTime::Seconds() - Start;
+        return Run;
+    };
+
+    const FRun Exact = Measure(EHexHeuristic::HexDistance, 1.f);
+    const FRun ALT = Measure(EHexHeuristic::Landmarks, 1.f);
+    const FRun Weighted = Measure(EHexHeuristic::Weighted, 1.5f);
+    const FRun Greedy = Measure(EHexHeuristic::Weighted, 3.f);
+    const FRun Manhattan = Measure(EHexHeuristic::Manhattan, 1.f);
+
+    auto Report = [&](const TCHAR* Name, const FRun& Run)
+    {
+        AddInfo(FString::Printf(TEXT("%s: %.2f ms, %lld nodes, %.0f nodes per query, cost %.3fx of HexDistance"), Name, Run.Seconds * 1000.0,
+            Run.Nodes, static_cast<double>(Run.Nodes) / Queries.size(), Run.Cost / FMath::Max(Exact.Cost, 1.0)));
+    };
+    Report(TEXT("HexDistance"), Exact);
+    Report(TEXT("Landmarks"), ALT);
+    Report(TEXT("Weighted 1.5"), Weighted);
+    Report(TEXT("Weighted 3"), Greedy);
+    Report(TEXT("Manhattan"), Manhattan);
+
+    TestEqual(TEXT("Landmarks find paths of the same total cost"), ALT.Cost, Exact.Cost);
+    TestTrue(TEXT("Landmarks expand fewer nodes than HexDistance"), ALT.Nodes < Exact.Nodes);
+    TestTrue(TEXT("Weighted expands fewer nodes than HexDistance"), Weighted.Nodes < Exact.Nodes);
+    TestTrue(TEXT("Weighted paths stay within epsilon"), Weighted.Cost <= Exact.Cost * 1.5);
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HexIncrementalPlanner.h"
+#include "HexPathfinder.h"
+#include "HexTestTerrain.h"
+
+namespace
+{
+    // Tile within Radius of Center, anywhere when the grid has none there
+    int RandomNear(const HexTerrain& Terrain, const int Center, const int Radius, FRandomStream& Random)
+    {
+        const HexGridLayout& Layout = Terrain.GetLayout();
+        const Hex H = Layout.HexAt(Center);
+        const int Index = Layout.IndexOf(H.Q + Random.RandRange(-Radius, Radius), H.R + Random.RandRange(-Radius, Radius));
+        return Index != INDEX_NONE ? Index : Random.RandHelper(Terrain.Num());
+    }
+
+    // Like HexTest::IsValidPath, but the start may be blocked, both searches may leave a blocked start
+    bool IsValidPathFrom(const HexTerrain& Terrain, const std::vector<Hex>& Path, const Hex& Start, const Hex& End)
+    {
+        if (Path.size() < 2)
+        {
+            return Path.size() == 1 && Start == End && Path.front() == Start;
+        }
+
+        const std::vector<Hex> Rest(Path.begin() + 1, Path.end());
+        return Path.front() == Start && Hex::Distance(Path[0], Path[1]) == 1 && HexTest::IsValidPath(Terrain, Rest, Path[1], End);
+    }
+
+    struct FHexPlannerResults
+    {
+        int Queries = 0;
+        int Found = 0;
+        int FoundMismatches = 0;
+        int InvalidPaths = 0;
+        int CostMismatches = 0;
+    };
+
+    // Moves the goal, edits tiles and now and then moves the start between planner queries,
+    // every answer is checked against a fresh A* search on the same terrain
+    FHexPlannerResults RunEditsAndGoalMoves(HexTerrain& Terrain, const int32 Seed, const int Steps)
+    {
+        HexIncrementalPlanner Planner;
+        Planner.Init(&Terrain, Terrain.GetMinCost());
+
+        HexSearchSettings Settings;
+        Settings.Heuristic = EHexHeuristic::HexDistance;
+        HexSearchContext Context;
+
+        FRandomStream Random(Seed);
+        const HexGridLayout& Layout = Terrain.GetLayout();
+        int StartIndex = HexTest::RandomPassable(Terrain, Random);
+        int GoalIndex = HexTest::RandomPassable(Terrain, Random);
+
+        FHexPlannerResults Results;
+        std::vector<Hex> Path;
+        std::vector<Hex> Expected;
+        HexPath PackedPath;
+        for (int Step = 0; Step < Steps; Step++)
+        {
+            const float Roll = Random.GetFraction();
+            if (Roll < 0.05f)
+            {
+                // A new root, the planner starts over
+                StartIndex = HexTest::RandomPassable(Terrain, Random);
+            }
+            else if (Roll < 0.5f)
+            {
+                // Mostly small moves like a drag, sometimes a jump across the map
+                GoalIndex = Random.FRand() < 0.8f ? RandomNear(Terrain, GoalIndex, 2, Random) : Random.RandHelper(Terrain.Num());
+            }
+
+            // Edits near the current path and anywhere else, the start and goal tiles included
+            const int Edits = Random.RandHelper(4);
+            for (int Edit = 0; Edit < Edits; Edit++)
+            {
+                const int Index = Random.FRand() < 0.5f && !Path.empty()
+                    ? Layout.IndexOf(Path[Random.RandHelper(static_cast<int>(Path.size()))]) : Random.RandHelper(Terrain.Num());
+                const EHexTypes Types[] = { EHexTypes::Dirt, EHexTypes::Grass, EHexTypes::Water, EHexTypes::Blocked };
+                HexTest::SetTile(Terrain, Index, Types[Random.RandHelper(4)]);
+                Planner.OnTileChanged(Index);
+            }
+
+            // Now and then the map is repainted ten times over before the next query, like a regenerated map.
+            // That queues more entries than the heap keeps before it rebuilds itself from the open tiles.
+            if (Step % 250 == 249)
+            {
+                for (int Repaint = 0; Repaint < Terrain.Num() * 10; Repaint++)
+                {
+                    const int Index = Random.RandHelper(Terrain.Num());
+                    const EHexTypes Types[] = { EHexTypes::Dirt, EHexTypes::Grass, EHexTypes::Water };
+                    HexTest::SetTile(Terrain, Index, Random.FRand() < 0.25f ? EHexTypes::Blocked : Types[Random.RandHelper(3)]);
+                    Planner.OnTileChanged(Index);
+                }
+            }
+
+            const Hex Start = Layout.HexAt(StartIndex);
+            const Hex Goal = Layout.HexAt(GoalIndex);
+            const bool ExpectedFound = HexPathfinder::FindShortestPath(Terrain, Context, Start, Goal, Expected, Settings);
+
+            // Every other query goes through the packed path, it shares the repaired search
+            bool Found = false;
+            if (Step % 2 == 0)
+            {
+                Found = Planner.FindPath(Start, Goal, Path);
+            }
+            else
+            {
+                Found = Planner.FindPath(Start, Goal, PackedPath);
+                Path.clear();
+                for (const Hex& H : PackedPath)
+                {
+                    Path.push_back(H);
+                }
+            }
+
+            Results.Queries++;
+            Results.Found += Found;
+            Results.FoundMismatches += Found != ExpectedFound;
+            if (Found && ExpectedFound)
+            {
+                Results.InvalidPaths += !IsValidPathFrom(Terrain, Path, Start, Goal);
+                Results.CostMismatches += !FMath::IsNearlyEqual(HexTest::PathCost(Terrain, Path), HexTest::PathCost(Terrain, Expected), 1e-3);
+            }
+        }
+
+        return Results;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexIncrementalPlannerTest, "UOCTest.Hex.IncrementalPlanner.MatchesAStarAfterEdits",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexIncrementalPlannerTest::RunTest(const FString& Parameters)
+{
+    struct FCase
+    {
+        const TCHAR* Name;
+        HexGridLayout Layout;
+        int Steps;
+    };
+
+    // The small map goes through the most repaints, every one of them passes the heap rebuild limit
+    const FCase Cases[] = {
+        { TEXT("20x20"), HexGridLayout(-10, 9, -10, 9), 3000 },
+        { TEXT("60x60"), HexGridLayout(-30, 29, -30, 29), 400 },
+    };
+
+    for (const FCase& Case : Cases)
+    {
+        HexTerrain Terrain;
+        HexTest::MakeTerrain(Terrain, Case.Layout, 5, 0.25f);
+
+        const FHexPlannerResults Results = RunEditsAndGoalMoves(Terrain, 50, Case.Steps);
+        AddInfo(FString::Printf(TEXT("%s: %d of %d queries found a path"), Case.Name, Results.Found, Results.Queries));
+
+        TestTrue(FString::Printf(TEXT("%s: some queries found a path"), Case.Name), Results.Found > Results.Queries / 4);
+        TestEqual(FString::Printf(TEXT("%s: queries where planner and A* disagree on reachability"), Case.Name), Results.FoundMismatches, 0);
+        TestEqual(FString::Printf(TEXT("%s: invalid planner paths"), Case.Name), Results.InvalidPaths, 0);
+        TestEqual(FString::Printf(TEXT("%s: planner paths that cost more or less than A*"), Case.Name), Results.CostMismatches, 0);
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,305 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include <unordered_map>
+#include <vector>
+
+#include "HexGridManager.h"
+#include "HexKeyMap.h"
+
+namespace
+{
+    // The hash std::hash<Hex> used before HexKey, kept as the baseline the packed key replaced
+    struct FHexCombineHash
+    {
+        static size_t Combine(const int H1, const int H2)
+        {
+            return H1 ^ (H2 + 0x9e3779b9 + (H1 << 6) + (H1 >> 2));
+        }
+
+        size_t operator()(const Hex& H) const noexcept
+        {
+            return Combine(static_cast<int>(Combine(H.Q, H.R)), H.S);
+        }
+    };
+
+    // Spread over half the int32 range, so S = -Q-R still fits and the reserved empty key never comes up
+    Hex RandomSparseHex(FRandomStream& Random)
+    {
+        const int32 Q = static_cast<int32>(Random.GetUnsignedInt()) >> 1;
+        const int32 R = static_cast<int32>(Random.GetUnsignedInt()) >> 1;
+        return Hex(Q, R);
+    }
+
+    // A filled square of Side x Side tiles with its corner at (Q, R), the case that clustered in the old hash
+    std::vector<Hex> MakeDenseKeys(const int Q, const int R, const int Side)
+    {
+        std::vector<Hex> Keys;
+        Keys.reserve(static_cast<size_t>(Side) * Side);
+        for (int Column = 0; Column < Side; Column++)
+        {
+            for (int Row = 0; Row < Side; Row++)
+            {
+                Keys.push_back(Hex(Q + Column, R + Row));
+            }
+        }
+
+        return Keys;
+    }
+
+    std::vector<Hex> MakeSparseKeys(const int Count, const int32 Seed)
+    {
+        FRandomStream Random(Seed);
+        std::unordered_map<Hex, int> Unique;
+        std::vector<Hex> Keys;
+        Keys.reserve(Count);
+        while (static_cast<int>(Keys.size()) < Count)
+        {
+            const Hex H = RandomSparseHex(Random);
+            if (Unique.emplace(H, 0).second)
+            {
+                Keys.push_back(H);
+            }
+        }
+
+        return Keys;
+    }
+
+    struct FHexMapTimes
+    {
+        double Insert = 0.0;
+        double Hit = 0.0;
+        double Miss = 0.0;
+        double Remove = 0.0;
+        int64 Checksum = 0;
+    };
+
+    template<typename HashType>
+    FHexMapTimes TimeStdMap(const std::vector<Hex>& Keys, const std::vector<Hex>& Misses)
+    {
+        FHexMapTimes Times;
+        std::unordered_map<Hex, int, HashType> Map;
+
+        double Start = FPlatformTime::Seconds();
+        for (int i = 0; i < static_cast<int>(Keys.size()); i++)
+        {
+            Map[Keys[i]] = i;
+        }
+        Times.Insert = FPlatformTime::Seconds() - Start;
+
+        Start = FPlatformTime::Seconds();
+        for (const Hex& H : Keys)
+        {
+            const auto It = Map.find(H);
+            Times.Checksum += It != Map.end() ? It->second : 0;
+        }
+        Times.Hit = FPlatformTime::Seconds() - Start;
+
+        Start = FPlatformTime::Seconds();
+        for (const Hex& H : Misses)
+        {
+            Times.Checksum += Map.count(H);
+        }
+        Times.Miss = FPlatformTime::Seconds() - Start;
+
+        Start = FPlatformTime::Seconds();
+        for (const Hex& H : Keys)
+        {
+            Times.Checksum += Map.erase(H);
+        }
+        Times.Remove = FPlatformTime::Seconds() - Start;
+
+        return Times;
+    }
+
+    FHexMapTimes TimeKeyMap(const std::vector<Hex>& Keys, const std::vector<Hex>& Misses)
+    {
+        FHexMapTimes Times;
+        HexKeyMap<int> Map;
+
+        double Start = FPlatformTime::Seconds();
+        for (int i = 0; i < static_cast<int>(Keys.size()); i++)
+        {
+            Map.FindOrAdd(Keys[i]) = i;
+        }
+        Times.Insert = FPlatformTime::Seconds() - Start;
+
+        Start = FPlatformTime::Seconds();
+        for (const Hex& H : Keys)
+        {
+            const int* Value = Map.Find(H);
+            Times.Checksum += Value ? *Value : 0;
+        }
+        Times.Hit = FPlatformTime::Seconds() - Start;
+
+        Start = FPlatformTime::Seconds();
+        for (const Hex& H : Misses)
+        {
+            Times.Checksum += Map.Contains(H);
+        }
+        Times.Miss = FPlatformTime::Seconds() - Start;
+
+        Start = FPlatformTime::Seconds();
+        for (const Hex& H : Keys)
+        {
+            Times.Checksum += Map.Remove(H);
+        }
+        Times.Remove = FPlatformTime::Seconds() - Start;
+
+        return Times;
+    }
+
+    FString FormatTimes(const TCHAR* Name, const FHexMapTimes& Times, const int Count)
+    {
+        const auto NanosecondsPerKey = [Count](const double Seconds) { return Seconds * 1000000000.0 / Count; };
+        return FString::Printf(TEXT("%s: insert %.1f ns, hit %.1f ns, miss %.1f ns, remove %.1f ns per key"), Name,
+            NanosecondsPerKey(Times.Insert), NanosecondsPerKey(Times.Hit), NanosecondsPerKey(Times.Miss), NanosecondsPerKey(Times.Remove));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexKeyRoundTripTest, "UOCTest.Hex.KeyMap.KeyRoundTrip",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexKeyRoundTripTest::RunTest(const FString& Parameters)
+{
+    std::vector<Hex> Hexes = { Hex(0, 0), Hex(-1, 0), Hex(0, -1), Hex(-1, -1), Hex(MAX_int32, MIN_int32 + 1),
+        Hex(MIN_int32 + 1, MAX_int32), Hex(MAX_int32, 0), Hex(0, MIN_int32 + 1), Hex(12345, -67890) };
+
+    FRandomStream Random(15);
+    for (int i = 0; i < 10000; i++)
+    {
+        Hexes.push_back(RandomSparseHex(Random));
+    }
+
+    int Mismatches = 0;
+    for (const Hex& H : Hexes)
+    {
+        const HexKey Key(H);
+        Mismatches += Key.ToHex() != H || HexKey::FromValue(Key.Value) != Key || Key.GetQ() != H.Q || Key.GetR() != H.R;
+    }
+    TestEqual(TEXT("Hexes that didn't survive packing"), Mismatches, 0);
+
+    // Negative R must not borrow from Q
+    TestTrue(TEXT("(0, -1) and (-1, -1) get different keys"), HexKey(0, -1) != HexKey(-1, -1));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexKeyMapMatchesStdTest, "UOCTest.Hex.KeyMap.MatchesUnorderedMap",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexKeyMapMatchesStdTest::RunTest(const FString& Parameters)
+{
+    HexKeyMap<int> Map;
+    std::unordered_map<Hex, int> Expected;
+
+    // A small coordinate range so adds, overwrites and removes keep hitting the same keys and probe runs
+    FRandomStream Random(150);
+    int Mismatches = 0;
+    for (int Step = 0; Step < 200000; Step++)
+    {
+        const Hex H = Random.FRand() < 0.1f ? RandomSparseHex(Random) : Hex(Random.RandRange(-60, 60), Random.RandRange(-60, 60));
+        const int Operation = Random.RandRange(0, 2);
+        if (Operation == 0)
+        {
+            Map.Add(H, Step);
+            Expected[H] = Step;
+        }
+        else if (Operation == 1)
+        {
+            Mismatches += Map.Remove(H) != (Expected.erase(H) > 0);
+        }
+        else
+        {
+            const int* Value = Map.Find(H);
+            const auto It = Expected.find(H);
+            Mismatches += (Value != nullptr) != (It != Expected.end()) || (Value && *Value != It->second);
+        }
+    }
+    TestEqual(TEXT("Operations that disagreed with std::unordered_map"), Mismatches, 0);
+    TestEqual(TEXT("Entries"), Map.Num(), static_cast<int>(Expected.size()));
+
+    // Every entry is reachable after all the backward shifts, and nothing else is in the map
+    int Missing = 0;
+    for (const auto& Entry : Expected)
+    {
+        const int* Value = Map.Find(Entry.first);
+        Missing += !Value || *Value != Entry.second;
+    }
+    TestEqual(TEXT("Entries lost by the map"), Missing, 0);
+
+    int Visited = 0;
+    int Unexpected = 0;
+    Map.ForEach([&Expected, &Visited, &Unexpected](const Hex& H, const int Value)
+    {
+        const auto It = Expected.find(H);
+        Unexpected += It == Expected.end() || It->second != Value;
+        Visited++;
+    });
+    TestEqual(TEXT("Entries visited"), Visited, Map.Num());
+    TestEqual(TEXT("Entries that shouldn't be in the map"), Unexpected, 0);
+
+    Map.Reset();
+    TestTrue(TEXT("Map is empty after Reset"), Map.IsEmpty() && !Map.Contains(Hex(0, 0)));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexKeyMapPerfTest, "UOCTest.Hex.KeyMap.AgainstUnorderedMap",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FHexKeyMapPerfTest::RunTest(const FString& Parameters)
+{
+    constexpr int Side = 1024;
+    constexpr int Count = Side * Side;
+
+    struct FKeySet
+    {
+        const TCHAR* Name;
+        std::vector<Hex> Keys;
+        std::vector<Hex> Misses;
+    };
+
+    // Dense is a block of a bounded map, misses are the block next to it. Sparse is spread over the whole coordinate range.
+    FKeySet KeySets[] = {
+        { TEXT("Dense"), MakeDenseKeys(-Side / 2, -Side / 2, Side), MakeDenseKeys(Side / 2, -Side / 2, Side) },
+        { TEXT("Sparse"), MakeSparseKeys(Count, 1), {} },
+    };
+
+    // Random draws from a different seed, a hit is possible but vanishingly rare
+    FRandomStream Random(2);
+    KeySets[1].Misses.reserve(Count);
+    for (int i = 0; i < Count; i++)
+    {
+        KeySets[1].Misses.push_back(RandomSparseHex(Random));
+    }
+
+    for (FKeySet& Set : KeySets)
+    {
+        // Shuffled, so insertion order doesn't walk the table in hash order
+        FRandomStream Shuffle(3);
+        for (int i = Count - 1; i > 0; i--)
+        {
+            std::swap(Set.Keys[i], Set.Keys[Shuffle.RandRange(0, i)]);
+        }
+
+        const FHexMapTimes Combine = TimeStdMap<FHexCombineHash>(Set.Keys, Set.Misses);
+        const FHexMapTimes Std = TimeStdMap<std::hash<Hex>>(Set.Keys, Set.Misses);
+        const FHexMapTimes Packed = TimeKeyMap(Set.Keys, Set.Misses);
+
+        AddInfo(FString::Printf(TEXT("%s keys, %d of them"), Set.Name, Count));
+        AddInfo(FormatTimes(TEXT("  unordered_map, chained hash"), Combine, Count));
+        AddInfo(FormatTimes(TEXT("  unordered_map, std::hash<Hex>"), Std, Count));
+        AddInfo(FormatTimes(TEXT("  HexKeyMap"), Packed, Count));
+
+        TestEqual(FString::Printf(TEXT("%s: HexKeyMap found the same entries"), Set.Name), Packed.Checksum, Std.Checksum);
+        TestTrue(FString::Printf(TEXT("%s: HexKeyMap finds keys faster than unordered_map"), Set.Name), Packed.Hit < Std.Hit && Packed.Hit < Combine.Hit);
+    }
+
+    return true;
+}
+
+#endif
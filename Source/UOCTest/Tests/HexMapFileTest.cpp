@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/FileManager.h"
+#include "HexMapFile.h"
+#include "HexTestTerrain.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    // Two chunks, the second one partial. Bands of 97 tiles give RLE and LZ4 something to shrink.
+    void MakeBandedTerrain(HexTerrain& Terrain)
+    {
+        Terrain.Init(HexGridLayout(-150, 149, -150, 149), EHexTypes::Dirt, HexTest::TypeCost(EHexTypes::Dirt), 1.f);
+
+        const EHexTypes Types[] = { EHexTypes::Dirt, EHexTypes::Grass, EHexTypes::Water, EHexTypes::Blocked };
+        for (int Index = 0; Index < Terrain.Num(); Index++)
+        {
+            HexTest::SetTile(Terrain, Index, Types[Index / 97 % 4]);
+        }
+    }
+
+    FString TestMapPath(const TCHAR* Name)
+    {
+        return FPaths::Combine(FPaths::AutomationTransientDir(), Name);
+    }
+
+    // Opens the file and reads it, false when either step rejects it
+    bool LoadTypes(const FString& Path, std::vector<EHexTypes>& OutTypes)
+    {
+        HexMapFile Map;
+        if (!Map.Open(Path))
+        {
+            return false;
+        }
+
+        OutTypes.assign(Map.GetLayout().Num(), EHexTypes::Invalid);
+        return Map.ReadTypes(OutTypes.data());
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexMapFileRoundTripTest, "UOCTest.Hex.MapFile.RoundTrip",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexMapFileRoundTripTest::RunTest(const FString& Parameters)
+{
+    HexTerrain Terrain;
+    MakeBandedTerrain(Terrain);
+    const FString Path = TestMapPath(TEXT("HexMapFileRoundTrip.hexmap"));
+
+    const TPair<EHexMapCompression, const TCHAR*> Compressions[] = {
+        { EHexMapCompression::None, TEXT("Raw") },
+        { EHexMapCompression::RLE, TEXT("RLE") },
+        { EHexMapCompression::LZ4, TEXT("LZ4") },
+    };
+
+    for (const TPair<EHexMapCompression, const TCHAR*>& Entry : Compressions)
+    {
+        const EHexMapCompression Compression = Entry.Key;
+        const TCHAR* Name = Entry.Value;
+
+        int64 FileBytes = 0;
+        if (!TestTrue(FString::Printf(TEXT("%s map saved"), Name), HexMapFile::Save(Path, Terrain, Compression, &FileBytes)))
+        {
+            continue;
+        }
+
+        // Raw chunks hold a byte per tile, the compressed ones have to be smaller
+        if (Compression != EHexMapCompression::None)
+        {
+            TestTrue(FString::Printf(TEXT("%s map is smaller than the tiles"), Name), FileBytes < Terrain.Num());
+        }
+
+        HexMapFile Map;
+        if (!TestTrue(FString::Printf(TEXT("%s map opened"), Name), Map.Open(Path)))
+        {
+            continue;
+        }
+
+        TestTrue(FString::Printf(TEXT("%s map layout"), Name), Map.GetLayout() == Terrain.GetLayout());
+        TestEqual(FString::Printf(TEXT("%s map file size"), Name), Map.GetFileBytes(), FileBytes);
+
+        std::vector<EHexTypes> Types(Map.GetLayout().Num(), EHexTypes::Invalid);
+        TestTrue(FString::Printf(TEXT("%s map read"), Name), Map.ReadTypes(Types.data()));
+
+        int Mismatches = 0;
+        for (int Index = 0; Index < Terrain.Num() && Index < static_cast<int>(Types.size()); Index++)
+        {
+            Mismatches += Types[Index] != Terrain.GetType(Index);
+        }
+        TestEqual(FString::Printf(TEXT("%s map tiles that differ"), Name), Mismatches, 0);
+    }
+
+    IFileManager::Get().Delete(*Path);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexMapFileDamagedTest, "UOCTest.Hex.MapFile.RejectsDamagedFiles",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexMapFileDamagedTest::RunTest(const FString& Parameters)
+{
+    HexTerrain Terrain;
+    MakeBandedTerrain(Terrain);
+
+    const FString Path = TestMapPath(TEXT("HexMapFileSource.hexmap"));
+    const FString DamagedPath = TestMapPath(TEXT("HexMapFileDamaged.hexmap"));
+    TArray<uint8> Bytes;
+    if (!TestTrue(TEXT("Map saved"), HexMapFile::Save(Path, Terrain, EHexMapCompression::RLE)) ||
+        !TestTrue(TEXT("Map loaded as bytes"), FFileHelper::LoadFileToArray(Bytes, *Path)))
+    {
+        return false;
+    }
+
+    std::vector<EHexTypes> Types;
+    TestTrue(TEXT("Undamaged map loads"), LoadTypes(Path, Types));
+    TestFalse(TEXT("Missing map loads"), LoadTypes(TestMapPath(TEXT("HexMapFileMissing.hexmap")), Types));
+
+    // Every case damages a copy of the saved file
+    auto TestDamaged = [&](const TCHAR* What, TFunctionRef<void(TArray<uint8>&)> Damage)
+    {
+        TArray<uint8> Damaged = Bytes;
+        Damage(Damaged);
+        if (TestTrue(FString::Printf(TEXT("%s map saved"), What), FFileHelper::SaveArrayToFile(Damaged, *DamagedPath)))
+        {
+            TestFalse(FString::Printf(TEXT("%s map loads"), What), LoadTypes(DamagedPath, Types));
+        }
+    };
+
+    TestDamaged(TEXT("Empty"), [](TArray<uint8>& Damaged) { Damaged.Reset(); });
+    TestDamaged(TEXT("Header only"), [](TArray<uint8>& Damaged) { Damaged.SetNum(8 * sizeof(int32)); });
+    TestDamaged(TEXT("Truncated"), [](TArray<uint8>& Damaged) { Damaged.SetNum(Damaged.Num() - 1); });
+    TestDamaged(TEXT("Foreign"), [](TArray<uint8>& Damaged) { Damaged[0] ^= 0xFF; });
+    TestDamaged(TEXT("Future version"), [](TArray<uint8>& Damaged) { Damaged[4] = static_cast<uint8>(HexMapFile::Version + 1); });
+    TestDamaged(TEXT("Wrong tile count"), [](TArray<uint8>& Damaged) { Damaged[16] ^= 0x01; });
+
+    // The last run of the last chunk ends the file, a different count no longer adds up to the chunk
+    TestDamaged(TEXT("Bad run"), [](TArray<uint8>& Damaged)
+    {
+        uint8& Count = Damaged[Damaged.Num() - 2];
+        Count = Count > 1 ? Count - 1 : 2;
+    });
+
+    IFileManager::Get().Delete(*Path);
+    IFileManager::Get().Delete(*DamagedPath);
+    return true;
+}
+
+#endif
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include <algorithm>
+
+#include "HexMovementRange.h"
+#include "HexTestTerrain.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexMovementRangeTest, "UOCTest.Hex.MovementRange.Costs",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexMovementRangeTest::RunTest(const FString& Parameters)
+{
+    HexSearchContext Context;
+    HexMovementRange Range;
+
+    // On dirt every step costs 1, the range is the disc of the budget
+    {
+        HexTerrain Terrain;
+        Terrain.Init(HexGridLayout(-30, 30, -30, 30), EHexTypes::Dirt, HexTest::TypeCost(EHexTypes::Dirt), 1.f);
+        Range.Build(Terrain, Context, Hex(0, 0), 20.f);
+        TestEqual(TEXT("Tiles within 20 steps, start included"), static_cast<int>(Range.GetTiles().size()), Hex::GetHexCountForRange(20) + 1);
+        TestFalse(TEXT("Tile 21 steps away"), Range.Contains(Hex(21, 0)));
+    }
+
+    // Every reachable tile costs what the cheapest path there costs, and its stored path is that cheap
+    HexTerrain Terrain;
+    HexTest::MakeTerrain(Terrain, HexGridLayout(-30, 30, -30, 30), 21, 0.2f);
+    FRandomStream Random(2);
+    const Hex Start = Terrain.GetLayout().HexAt(HexTest::RandomPassable(Terrain, Random));
+    Range.Build(Terrain, Context, Start, 20.f);
+    TestTrue(TEXT("Start is in range"), Range.Contains(Start));
+
+    HexSearchContext PathContext;
+    HexSearchSettings Settings;
+    Settings.Heuristic = EHexHeuristic::HexDistance;
+    std::vector<Hex> Path;
+    HexPath RangePath;
+    int Mismatches = 0;
+    for (const HexReachableTile& Tile : Range.GetTiles())
+    {
+        const Hex To = Range.GetHex(Tile);
+        if (!HexPathfinder::FindShortestPath(Terrain, PathContext, Start, To, Path, Settings) ||
+            !FMath::IsNearlyEqual(HexTest::PathCost(Terrain, Path), static_cast<double>(Tile.Cost)) || Tile.Cost > Range.GetBudget() || !Range.GetPath(To, RangePath))
+        {
+            Mismatches++;
+            continue;
+        }
+
+        std::vector<Hex> Stored(RangePath.begin(), RangePath.end());
+        Mismatches += !FMath::IsNearlyEqual(HexTest::PathCost(Terrain, Stored), static_cast<double>(Tile.Cost));
+    }
+    TestEqual(TEXT("Tiles whose cost differs from the cheapest path"), Mismatches, 0);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexMovementRangePerfTest, "UOCTest.Hex.MovementRange.Range20Timing",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FHexMovementRangePerfTest::RunTest(const FString& Parameters)
+{
+    // Dirt everywhere is the worst case, every tile of the disc is reached
+    HexTerrain Open;
+    Open.Init(HexGridLayout(-256, 255, -256, 255), EHexTypes::Dirt, HexTest::TypeCost(EHexTypes::Dirt), 1.f);
+    HexTerrain Mixed;
+    HexTest::MakeTerrain(Mixed, Open.GetLayout(), 20, 0.1f);
+
+    HexSearchContext Context;
+    HexMovementRange Range;
+    for (const HexTerrain* Terrain : { &Open, &Mixed })
+    {
+        const TCHAR* Name = Terrain == &Open ? TEXT("Dirt") : TEXT("Mixed");
+
+        FRandomStream Random(14);
+        std::vector<double> Seconds;
+        int64 Tiles = 0;
+        for (int Query = 0; Query < 201; Query++)
+        {
+            const Hex Start = Terrain->GetLayout().HexAt(HexTest::RandomPassable(*Terrain, Random));
+            const double Time = FPlatformTime::Seconds();
+            Range.Build(*Terrain, Context, Start, 20.f);
+
+            // The first query grows the arrays
+            if (Query > 0)
+            {
+                Seconds.push_back(FPlatformTime::Seconds() - Time);
+                Tiles += Range.GetTiles().size();
+            }
+        }
+
+        std::sort(Seconds.begin(), Seconds.end());
+        const double Median = Seconds[Seconds.size() / 2];
+        const double Worst = Seconds.back();
+        AddInfo(FString::Printf(TEXT("%s range 20 on %d tiles: median %.3f ms, worst %.3f ms, %lld tiles per range"),
+            Name, Terrain->Num(), Median * 1000.0, Worst * 1000.0, Tiles / static_cast<int64>(Seconds.size())));
+
+        TestTrue(FString::Printf(TEXT("%s range 20 takes under 1 ms"), Name), Median < 0.001);
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include <atomic>
+
+#include "HexPathfinder.h"
+#include "HexTestTerrain.h"
+
+namespace
+{
+    // Counts the allocations made by the thread that created it, everything is passed on to the
+    // allocator it replaces. Other threads keep allocating through it while it is installed.
+    class FHexCountingMalloc final : public FMalloc
+    {
+    public:
+        explicit FHexCountingMalloc(FMalloc* InInner) :
+            Inner(InInner), ThreadId(FPlatformTLS::GetCurrentThreadId()) {}
+
+        virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+        {
+            CountAllocation();
+            return Inner->Malloc(Count, Alignment);
+        }
+
+        virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+        {
+            if (Count > 0)
+            {
+                CountAllocation();
+            }
+            return Inner->Realloc(Original, Count, Alignment);
+        }
+
+        virtual void Free(void* Original) override
+        {
+            Inner->Free(Original);
+        }
+
+        virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+        {
+            return Inner->QuantizeSize(Count, Alignment);
+        }
+
+        virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+        {
+            return Inner->GetAllocationSize(Original, SizeOut);
+        }
+
+        virtual bool IsInternallyThreadSafe() const override
+        {
+            return Inner->IsInternallyThreadSafe();
+        }
+
+        virtual const TCHAR* GetDescriptiveName() override
+        {
+            return Inner->GetDescriptiveName();
+        }
+
+        int32 GetAllocations() const
+        {
+            return Allocations.load(std::memory_order_relaxed);
+        }
+
+    private:
+        void CountAllocation()
+        {
+            if (FPlatformTLS::GetCurrentThreadId() == ThreadId)
+            {
+                Allocations.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        FMalloc* Inner;
+        uint32 ThreadId;
+        std::atomic<int32> Allocations { 0 };
+    };
+
+    // Routes GMalloc through a counter for its lifetime
+    class FHexAllocationScope
+    {
+    public:
+        FHexAllocationScope() :
+            Previous(GMalloc), Counter(GMalloc)
+        {
+            GMalloc = &Counter;
+        }
+
+        ~FHexAllocationScope()
+        {
+            GMalloc = Previous;
+        }
+
+        int32 GetAllocations() const
+        {
+            return Counter.GetAllocations();
+        }
+
+    private:
+        FMalloc* Previous;
+        FHexCountingMalloc Counter;
+    };
+
+    struct FHexQuery
+    {
+        Hex Start;
+        Hex End;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexPathfinderNoAllocationTest, "UOCTest.Hex.Pathfinder.NoAllocationsAfterWarmUp",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexPathfinderNoAllocationTest::RunTest(const FString& Parameters)
+{
+    HexTerrain Terrain;
+    HexTest::MakeTerrain(Terrain, HexGridLayout(-40, 40, -40, 40), 42, 0.2f);
+
+    FRandomStream Random(3);
+    std::vector<FHexQuery> Queries;
+    for (int i = 0; i < 64; i++)
+    {
+        Queries.push_back(FHexQuery { Terrain.GetLayout().HexAt(HexTest::RandomPassable(Terrain, Random)),
+            Terrain.GetLayout().HexAt(HexTest::RandomPassable(Terrain, Random)) });
+    }
+
+    for (const EHexOpenList OpenList : { EHexOpenList::BinaryHeap, EHexOpenList::Buckets })
+    {
+        HexSearchSettings Settings;
+        Settings.OpenList = OpenList;
+        Settings.Heuristic = EHexHeuristic::HexDistance;
+
+        HexSearchContext Context;
+        std::vector<Hex> Path;
+        HexPath PackedPath;
+
+        // The first round grows the context, the open list and the paths to what these queries need
+        for (const FHexQuery& Query : Queries)
+        {
+            HexPathfinder::FindShortestPath(Terrain, Context, Query.Start, Query.End, Path, Settings);
+            HexPathfinder::FindShortestPath(Terrain, Context, Query.Start, Query.End, PackedPath, Settings);
+        }
+
+        int32 Allocations = 0;
+        int Found = 0;
+        {
+            FHexAllocationScope Scope;
+            for (const FHexQuery& Query : Queries)
+            {
+                Found += HexPathfinder::FindShortestPath(Terrain, Context, Query.Start, Query.End, Path, Settings);
+                Found += HexPathfinder::FindShortestPath(Terrain, Context, Query.Start, Query.End, PackedPath, Settings);
+            }
+            Allocations = Scope.GetAllocations();
+        }
+
+        const TCHAR* Name = OpenList == EHexOpenList::Buckets ? TEXT("bucket queue") : TEXT("binary heap");
+        TestTrue(FString::Printf(TEXT("Paths found with the %s"), Name), Found > 0);
+        TestEqual(FString::Printf(TEXT("Allocations of repeated searches with the %s"), Name), Allocations, 0);
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,226 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include <unordered_map>
+
+#include "HexRegions.h"
+#include "HexTestTerrain.h"
+
+namespace
+{
+    // Incremental regions that don't group the passable tiles the way a fresh build does
+    int CountPartitionMismatches(const HexTerrain& Terrain, HexRegions& Regions)
+    {
+        HexRegions Fresh;
+        Fresh.Build(&Terrain);
+
+        // Both labelings have to map onto each other one to one
+        std::unordered_map<int, int> FreshToRegion;
+        std::unordered_map<int, int> RegionToFresh;
+        int Mismatches = 0;
+        for (int Index = 0; Index < Terrain.Num(); Index++)
+        {
+            const int Expected = Fresh.GetRegion(Index);
+            const int Actual = Regions.GetRegion(Index);
+            if (Expected == INDEX_NONE || Actual == INDEX_NONE)
+            {
+                Mismatches += Expected != Actual;
+                continue;
+            }
+
+            const int Mapped = FreshToRegion.emplace(Expected, Actual).first->second;
+            const int Back = RegionToFresh.emplace(Actual, Expected).first->second;
+            Mismatches += Mapped != Actual || Back != Expected;
+        }
+
+        return Mismatches;
+    }
+
+    // Random pairs, blocked starts included, where CanReach disagrees with a fresh build
+    int CountReachMismatches(const HexTerrain& Terrain, HexRegions& Regions, FRandomStream& Random, const int Pairs)
+    {
+        HexRegions Fresh;
+        Fresh.Build(&Terrain);
+
+        const HexGridLayout& Layout = Terrain.GetLayout();
+        int Mismatches = 0;
+        for (int Pair = 0; Pair < Pairs; Pair++)
+        {
+            const Hex Start = Layout.HexAt(Random.RandHelper(Terrain.Num()));
+            const Hex End = Layout.HexAt(Random.RandHelper(Terrain.Num()));
+            Mismatches += Regions.CanReach(Start, End) != Fresh.CanReach(Start, End);
+        }
+
+        return Mismatches;
+    }
+
+    // Walks Length steps from Index in Direction, INDEX_NONE once it leaves the grid
+    int Step(const HexGridLayout& Layout, int Index, const int Direction, const int Length)
+    {
+        for (int i = 0; i < Length && Index != INDEX_NONE; i++)
+        {
+            Index = Layout.NeighborIndex(Index, Direction);
+        }
+
+        return Index;
+    }
+
+    // Blocked terrain with a passable center and arms of three tiles in directions 0, 2 and 4,
+    // so the center's ring has three runs. With Closed the arm ends are joined by a ring around the center.
+    int MakeJunction(HexTerrain& Terrain, const bool Closed)
+    {
+        const HexGridLayout Layout(-5, 5, -5, 5);
+        Terrain.Init(Layout, EHexTypes::Blocked, HexTest::TypeCost(EHexTypes::Blocked), 1.f);
+
+        const int Center = Layout.IndexOf(Hex(0, 0));
+        HexTest::SetTile(Terrain, Center, EHexTypes::Dirt);
+        for (const int Direction : { 0, 2, 4 })
+        {
+            for (int Length = 1; Length <= 3; Length++)
+            {
+                HexTest::SetTile(Terrain, Step(Layout, Center, Direction, Length), EHexTypes::Dirt);
+            }
+        }
+
+        if (Closed)
+        {
+            for (int Index = 0; Index < Terrain.Num(); Index++)
+            {
+                if (Hex::Distance(Layout.HexAt(Index), Hex(0, 0)) == 3)
+                {
+                    HexTest::SetTile(Terrain, Index, EHexTypes::Grass);
+                }
+            }
+        }
+
+        return Center;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexRegionsRingRunsTest, "UOCTest.Hex.Regions.RingRuns",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexRegionsRingRunsTest::RunTest(const FString& Parameters)
+{
+    // A single column, every tile between the ends has a ring of two runs
+    {
+        HexTerrain Terrain;
+        Terrain.Init(HexGridLayout(0, 0, 0, 9), EHexTypes::Dirt, HexTest::TypeCost(EHexTypes::Dirt), 1.f);
+        HexRegions Regions;
+        Regions.Build(&Terrain);
+
+        const Hex Top = Terrain.GetLayout().HexAt(0);
+        const Hex Bottom = Terrain.GetLayout().HexAt(9);
+        HexTest::SetTile(Terrain, 5, EHexTypes::Blocked);
+        Regions.OnTileChanged(5);
+        TestFalse(TEXT("Column is cut by its blocked middle"), Regions.CanReach(Top, Bottom));
+        TestEqual(TEXT("Column regions after the cut"), CountPartitionMismatches(Terrain, Regions), 0);
+
+        HexTest::SetTile(Terrain, 5, EHexTypes::Dirt);
+        Regions.OnTileChanged(5);
+        TestTrue(TEXT("Column joins again"), Regions.CanReach(Top, Bottom));
+        TestEqual(TEXT("Column regions after the join"), CountPartitionMismatches(Terrain, Regions), 0);
+    }
+
+    // Three arms that only meet at the center, and three arms that also meet on a ring around it
+    for (const bool Closed : { false, true })
+    {
+        HexTerrain Terrain;
+        const int Center = MakeJunction(Terrain, Closed);
+        const HexGridLayout& Layout = Terrain.GetLayout();
+        HexRegions Regions;
+        Regions.Build(&Terrain);
+
+        const Hex Ends[] = { Layout.HexAt(Step(Layout, Center, 0, 3)), Layout.HexAt(Step(Layout, Center, 2, 3)), Layout.HexAt(Step(Layout, Center, 4, 3)) };
+        const TCHAR* Name = Closed ? TEXT("closed junction") : TEXT("open junction");
+
+        HexTest::SetTile(Terrain, Center, EHexTypes::Blocked);
+        Regions.OnTileChanged(Center);
+        for (int Arm = 0; Arm < 3; Arm++)
+        {
+            TestTrue(FString::Printf(TEXT("Arm %d reaches arm %d of the %s only around the ring"), Arm, (Arm + 1) % 3, Name),
+                Regions.CanReach(Ends[Arm], Ends[(Arm + 1) % 3]) == Closed);
+        }
+        TestEqual(FString::Printf(TEXT("Regions of the blocked %s"), Name), CountPartitionMismatches(Terrain, Regions), 0);
+
+        // The blocked center still reaches every arm, paths may leave a blocked start
+        TestTrue(FString::Printf(TEXT("Blocked center of the %s reaches an arm"), Name), Regions.CanReach(Layout.HexAt(Center), Ends[0]));
+
+        HexTest::SetTile(Terrain, Center, EHexTypes::Dirt);
+        Regions.OnTileChanged(Center);
+        TestTrue(FString::Printf(TEXT("Arms of the %s join again"), Name), Regions.CanReach(Ends[0], Ends[2]));
+        TestEqual(FString::Printf(TEXT("Regions of the reopened %s"), Name), CountPartitionMismatches(Terrain, Regions), 0);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexRegionsRebuildTest, "UOCTest.Hex.Regions.RebuildAfterManySplits",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexRegionsRebuildTest::RunTest(const FString& Parameters)
+{
+    // Every cut of the column leaves a dead region behind, 200 cuts of a 10 tile column
+    // go past the limit of 2 * 10 + 64 regions more than once
+    HexTerrain Terrain;
+    Terrain.Init(HexGridLayout(0, 0, 0, 9), EHexTypes::Dirt, HexTest::TypeCost(EHexTypes::Dirt), 1.f);
+    HexRegions Regions;
+    Regions.Build(&Terrain);
+
+    FRandomStream Random(8);
+    int Mismatches = 0;
+    for (int Cut = 0; Cut < 200; Cut++)
+    {
+        const int Index = 1 + Random.RandHelper(8);
+        HexTest::SetTile(Terrain, Index, EHexTypes::Blocked);
+        Regions.OnTileChanged(Index);
+        Mismatches += CountPartitionMismatches(Terrain, Regions);
+        Mismatches += CountReachMismatches(Terrain, Regions, Random, 10);
+
+        HexTest::SetTile(Terrain, Index, EHexTypes::Dirt);
+        Regions.OnTileChanged(Index);
+        Mismatches += CountPartitionMismatches(Terrain, Regions);
+        Mismatches += CountReachMismatches(Terrain, Regions, Random, 10);
+    }
+    TestEqual(TEXT("Disagreements with a fresh build"), Mismatches, 0);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexRegionsRandomEditsTest, "UOCTest.Hex.Regions.RandomEdits",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexRegionsRandomEditsTest::RunTest(const FString& Parameters)
+{
+    // Close to the point where blocked tiles start cutting the map apart, so edits both split and merge regions
+    for (const float BlockedChance : { 0.2f, 0.4f })
+    {
+        HexTerrain Terrain;
+        HexTest::MakeTerrain(Terrain, HexGridLayout(-20, 19, -20, 19), 6, BlockedChance);
+        HexRegions Regions;
+        Regions.Build(&Terrain);
+
+        FRandomStream Random(60);
+        int PartitionMismatches = 0;
+        int ReachMismatches = 0;
+        for (int Edit = 0; Edit < 2000; Edit++)
+        {
+            const int Index = Random.RandHelper(Terrain.Num());
+            HexTest::SetTile(Terrain, Index, Terrain.IsPassable(Index) ? EHexTypes::Blocked : EHexTypes::Grass);
+            Regions.OnTileChanged(Index);
+
+            PartitionMismatches += CountPartitionMismatches(Terrain, Regions);
+            ReachMismatches += CountReachMismatches(Terrain, Regions, Random, 20);
+        }
+
+        TestEqual(FString::Printf(TEXT("Tiles grouped unlike a fresh build at %.0f%% blocked"), BlockedChance * 100.f), PartitionMismatches, 0);
+        TestEqual(FString::Printf(TEXT("CanReach answers unlike a fresh build at %.0f%% blocked"), BlockedChance * 100.f), ReachMismatches, 0);
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include <vector>
+
+#include "HexRunLength.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexRunLengthTest, "UOCTest.Hex.RunLength",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexRunLengthTest::RunTest(const FString& Parameters)
+{
+    // 600 tiles of one type need three runs, then single tiles of alternating types
+    std::vector<EHexTypes> Types(600, EHexTypes::Water);
+    for (int i = 0; i < 10; i++)
+    {
+        Types.push_back(i % 2 ? EHexTypes::Dirt : EHexTypes::Blocked);
+    }
+    const int Count = static_cast<int>(Types.size());
+
+    std::vector<uint8> Bytes(HexRunLength::MaxEncodedBytes(Count));
+    const int Written = HexRunLength::Encode(Types.data(), Count, Bytes.data());
+    TestEqual(TEXT("Encoded bytes"), Written, 2 * (3 + 10));
+    TestEqual(TEXT("First run"), static_cast<int>(Bytes[0]), 255);
+    Bytes.resize(Written);
+
+    std::vector<EHexTypes> Decoded(Count, EHexTypes::Invalid);
+    TestTrue(TEXT("Decoded"), HexRunLength::Decode(Bytes.data(), Bytes.size(), Decoded.data(), Count));
+    TestTrue(TEXT("Decoded types"), Decoded == Types);
+
+    TestFalse(TEXT("Decoded into fewer tiles"), HexRunLength::Decode(Bytes.data(), Bytes.size(), Decoded.data(), Count - 1));
+    TestFalse(TEXT("Decoded into more tiles"), HexRunLength::Decode(Bytes.data(), Bytes.size(), Decoded.data(), Count + 1));
+    TestFalse(TEXT("Decoded an odd byte count"), HexRunLength::Decode(Bytes.data(), Bytes.size() - 1, Decoded.data(), Count));
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include <vector>
+
+#include "Async/TaskGraphInterfaces.h"
+#include "HexGridManager.h"
+#include "HexTerrainGenerator.h"
+
+namespace
+{
+    // The generator with the spacings AHexGridManager derives from its default tile size
+    HexTerrainGenerator MakeGenerator(const int32 Seed)
+    {
+        const float OuterTileSize = GetDefault<AHexGridManager>()->GetOuterTileSize();
+
+        HexTerrainGeneratorSettings Settings;
+        Settings.Seed = Seed;
+
+        HexTerrainGenerator Generator;
+        Generator.Init(Settings, OuterTileSize * 1.5f, OuterTileSize * FMath::Sqrt(3.f) / 2.f);
+        return Generator;
+    }
+
+    std::vector<EHexTypes> Generate(const HexTerrainGenerator& Generator, const HexGridLayout& Layout)
+    {
+        std::vector<EHexTypes> Types(Layout.Num(), EHexTypes::Invalid);
+        Generator.Generate(Layout, Types.data());
+        return Types;
+    }
+
+    // Generates Layout as chunks of ChunkWidth x ChunkHeight tiles and copies them into the index order of Layout
+    std::vector<EHexTypes> GenerateInChunks(const HexTerrainGenerator& Generator, const HexGridLayout& Layout, const int ChunkWidth, const int ChunkHeight)
+    {
+        std::vector<EHexTypes> Types(Layout.Num(), EHexTypes::Invalid);
+        for (int Column = 0; Column < Layout.Width; Column += ChunkWidth)
+        {
+            for (int Row = 0; Row < Layout.Height; Row += ChunkHeight)
+            {
+                const HexGridLayout Chunk(Layout.Left + Column, Layout.Left + FMath::Min(Column + ChunkWidth, Layout.Width) - 1,
+                    Layout.Up + Row, Layout.Up + FMath::Min(Row + ChunkHeight, Layout.Height) - 1);
+                const std::vector<EHexTypes> ChunkTypes = Generate(Generator, Chunk);
+
+                for (int Index = 0; Index < Chunk.Num(); Index++)
+                {
+                    Types[Layout.IndexOf(Chunk.HexAt(Index))] = ChunkTypes[Index];
+                }
+            }
+        }
+
+        return Types;
+    }
+
+    int CountMismatches(const std::vector<EHexTypes>& A, const std::vector<EHexTypes>& B)
+    {
+        int Mismatches = 0;
+        for (size_t Index = 0; Index < A.size() && Index < B.size(); Index++)
+        {
+            Mismatches += A[Index] != B[Index];
+        }
+
+        return Mismatches + static_cast<int>(FMath::Abs(static_cast<int64>(A.size()) - static_cast<int64>(B.size())));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexTerrainGeneratorDeterminismTest, "UOCTest.Hex.TerrainGenerator.SameSeedSameMap",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHexTerrainGeneratorDeterminismTest::RunTest(const FString& Parameters)
+{
+    // Big enough to go through the worker threads, and off the origin on both axes
+    const HexGridLayout Layout(-150, 149, -97, 102);
+
+    const std::vector<EHexTypes> First = Generate(MakeGenerator(7), Layout);
+    const std::vector<EHexTypes> Second = Generate(MakeGenerator(7), Layout);
+
+    // Odd chunk sizes, so chunk rows start off the groups of four the whole map was sampled in, and the chunks stay single threaded
+    const std::vector<EHexTypes> Chunked = GenerateInChunks(MakeGenerator(7), Layout, 37, 29);
+
+    TestEqual(TEXT("Tiles that differ between two runs with the same seed"), CountMismatches(First, Second), 0);
+    TestEqual(TEXT("Tiles that differ when generated in chunks"), CountMismatches(First, Chunked), 0);
+
+    int Counts[static_cast<int>(EHexTypes::MAX)] = {};
+    for (const EHexTypes Type : First)
+    {
+        Counts[static_cast<int>(Type)]++;
+    }
+
+    TestEqual(TEXT("Tiles left without a type"), Counts[static_cast<int>(EHexTypes::Invalid)], 0);
+    for (const EHexTypes Type : { EHexTypes::Water, EHexTypes::Dirt, EHexTypes::Grass, EHexTypes::Blocked })
+    {
+        TestTrue(FString::Printf(TEXT("Map has tiles of type %d"), static_cast<int>(Type)), Counts[static_cast<int>(Type)] > 0);
+    }
+
+    // Another seed has to make another map
+    const std::vector<EHexTypes> Other = Generate(MakeGenerator(8), Layout);
+    TestTrue(TEXT("Different seeds make different maps"), CountMismatches(First, Other) > Layout.Num() / 10);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexTerrainGeneratorPerfTest, "UOCTest.Hex.TerrainGenerator.MillionTiles",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FHexTerrainGeneratorPerfTest::RunTest(const FString& Parameters)
+{
+    const HexGridLayout Layout(-500, 499, -500, 499);
+    const HexTerrainGenerator Generator = MakeGenerator(1337);
+    std::vector<EHexTypes> Types(Layout.Num());
+
+    // Best of a few runs, the first one also pages the output in and wakes the workers
+    double BestSeconds = TNumericLimits<double>::Max();
+    double TotalSeconds = 0.0;
+    constexpr int Runs = 5;
+    for (int Run = 0; Run < Runs; Run++)
+    {
+        const double Start = FPlatformTime::Seconds();
+        Generator.Generate(Layout, Types.data());
+        const double Seconds = FPlatformTime::Seconds() - Start;
+        BestSeconds = FMath::Min(BestSeconds, Seconds);
+        TotalSeconds += Seconds;
+    }
+
+    AddInfo(FString::Printf(TEXT("%d tiles: best %.2f ms, mean %.2f ms, %.0f M tiles/s on %d workers"), Layout.Num(),
+        BestSeconds * 1000.0, TotalSeconds * 1000.0 / Runs, Layout.Num() / BestSeconds / 1000000.0, FTaskGraphInterface::Get().GetNumWorkerThreads()));
+
+    TestTrue(TEXT("A million tiles generate well under a second"), BestSeconds < 0.25);
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "CoreMinimal.h"
+#include "HexGridManager.h"
+#include "HexTerrain.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Terrain and path helpers shared by the hex automation tests
+namespace HexTest
+{
+    // Same entries as AHexGridManager::HexTileCostMap
+    inline float TypeCost(const EHexTypes Type)
+    {
+        switch (Type)
+        {
+        case EHexTypes::Dirt: return 1.f;
+        case EHexTypes::Grass: return 3.f;
+        case EHexTypes::Water: return 5.f;
+        default: return AHexGridManager::UnknownTileCost;
+        }
+    }
+
+    inline void SetTile(HexTerrain& Terrain, const int Index, const EHexTypes Type)
+    {
+        Terrain.SetTile(Index, Type, TypeCost(Type));
+    }
+
+    // Dirt, grass and water in equal parts, BlockedChance of the tiles are blocked
+    inline void MakeTerrain(HexTerrain& Terrain, const HexGridLayout& Layout, const int32 Seed, const float BlockedChance)
+    {
+        Terrain.Init(Layout, EHexTypes::Dirt, TypeCost(EHexTypes::Dirt), 1.f);
+
+        FRandomStream Random(Seed);
+        for (int Index = 0; Index < Terrain.Num(); Index++)
+        {
+            if (Random.GetFraction() < BlockedChance)
+            {
+                SetTile(Terrain, Index, EHexTypes::Blocked);
+                continue;
+            }
+
+            const EHexTypes Types[] = { EHexTypes::Dirt, EHexTypes::Grass, EHexTypes::Water };
+            SetTile(Terrain, Index, Types[Random.RandHelper(3)]);
+        }
+    }
+
+    // Passable tile picked at random, INDEX_NONE when the terrain has none
+    inline int RandomPassable(const HexTerrain& Terrain, FRandomStream& Random)
+    {
+        for (int Attempt = 0; Attempt < 1000; Attempt++)
+        {
+            const int Index = Random.RandHelper(Terrain.Num());
+            if (Terrain.IsPassable(Index))
+            {
+                return Index;
+            }
+        }
+
+        return INDEX_NONE;
+    }
+
+    // Checks that Path goes from Start to End in single steps over passable tiles
+    inline bool IsValidPath(const HexTerrain& Terrain, const std::vector<Hex>& Path, const Hex& Start, const Hex& End)
+    {
+        if (Path.empty() || Path.front() != Start || Path.back() != End)
+        {
+            return false;
+        }
+
+        for (int i = 0; i < static_cast<int>(Path.size()); i++)
+        {
+            const int Index = Terrain.GetLayout().IndexOf(Path[i]);
+            if (Index == INDEX_NONE || !Terrain.IsPassable(Index) || (i > 0 && Hex::Distance(Path[i - 1], Path[i]) != 1))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Cheapest cost from Source to every tile, entering a tile pays its cost, INFINITY where it can't be reached.
+    // Reverse gives the cost from every tile to Source instead.
+    inline std::vector<double> Dijkstra(const HexTerrain& Terrain, const int Source, const bool Reverse = false)
+    {
+        typedef std::pair<double, int> FEntry;
+        std::vector<double> Costs(Terrain.Num(), INFINITY);
+        std::priority_queue<FEntry, std::vector<FEntry>, std::greater<FEntry>> Open;
+
+        Costs[Source] = 0.0;
+        Open.push(FEntry(0.0, Source));
+        while (!Open.empty())
+        {
+            const FEntry Current = Open.top();
+            Open.pop();
+            if (Current.first > Costs[Current.second])
+            {
+                continue;
+            }
+
+            for (const int Next : HexNeighbors(Terrain.GetLayout(), Current.second))
+            {
+                // Reverse steps go from Next into Current, so they pay for Current
+                const double NewCost = Current.first + Terrain.GetCost(Reverse ? Current.second : Next);
+                if (Terrain.IsPassable(Next) && NewCost < Costs[Next])
+                {
+                    Costs[Next] = NewCost;
+                    Open.push(FEntry(NewCost, Next));
+                }
+            }
+        }
+
+        return Costs;
+    }
+
+    // Sum of the tile costs entered after Start
+    inline double PathCost(const HexTerrain& Terrain, const std::vector<Hex>& Path)
+    {
+        double Cost = 0;
+        for (int i = 1; i < static_cast<int>(Path.size()); i++)
+        {
+            Cost += Terrain.GetCost(Terrain.GetLayout().IndexOf(Path[i]));
+        }
+
+        return Cost;
+    }
+}
+
+#endif